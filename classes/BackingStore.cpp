@@ -0,0 +1,113 @@
+// BackingStore.cpp
+#include "BackingStore.h"
+#include <iostream>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef _WIN32
+
+BackingStore::BackingStore(const std::string& filename) : filename(filename) {
+    handle = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                         NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "[MMU] CRITICAL ERROR: Could not open backing store " << filename << "." << std::endl;
+    }
+}
+
+BackingStore::~BackingStore() {
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+}
+
+bool BackingStore::isOpen() const {
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+bool BackingStore::readAt(long long offset, char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        OVERLAPPED at = {};
+        at.Offset = (DWORD)((offset + done) & 0xFFFFFFFF);
+        at.OffsetHigh = (DWORD)((offset + done) >> 32);
+        DWORD got = 0;
+        if (!ReadFile(handle, buffer + done, (DWORD)(size - done), &got, &at)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            std::cerr << "[MMU] CRITICAL ERROR: Backing store read failed." << std::endl;
+            return false;
+        }
+        if (got == 0) break;
+        done += got;
+    }
+    std::memset(buffer + done, 0, size - done);
+    return true;
+}
+
+bool BackingStore::writeAt(long long offset, const char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        OVERLAPPED at = {};
+        at.Offset = (DWORD)((offset + done) & 0xFFFFFFFF);
+        at.OffsetHigh = (DWORD)((offset + done) >> 32);
+        DWORD put = 0;
+        if (!WriteFile(handle, buffer + done, (DWORD)(size - done), &put, &at) || put == 0) {
+            std::cerr << "[MMU] CRITICAL ERROR: Backing store write failed." << std::endl;
+            return false;
+        }
+        done += put;
+    }
+    return true;
+}
+
+#else
+
+BackingStore::BackingStore(const std::string& filename) : filename(filename) {
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[MMU] CRITICAL ERROR: Could not open backing store " << filename
+                  << ": " << std::strerror(errno) << std::endl;
+    }
+}
+
+BackingStore::~BackingStore() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool BackingStore::isOpen() const {
+    return fd >= 0;
+}
+
+bool BackingStore::readAt(long long offset, char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = ::pread(fd, buffer + done, size - done, (off_t)(offset + done));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[MMU] CRITICAL ERROR: Backing store read failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (got == 0) break;    // end of file
+        done += (size_t)got;
+    }
+    std::memset(buffer + done, 0, size - done);
+    return true;
+}
+
+bool BackingStore::writeAt(long long offset, const char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t put = ::pwrite(fd, buffer + done, size - done, (off_t)(offset + done));
+        if (put < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[MMU] CRITICAL ERROR: Backing store write failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        done += (size_t)put;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,36 @@
+// BackingStore.h
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// The swap file, opened (and truncated) once for the life of the MMU. Pages
+// move with positioned reads and writes on that one descriptor, so there is
+// no per-fault open/seek/close and no shared file position: concurrent calls
+// are safe.
+class BackingStore {
+private:
+    std::string filename;
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+
+public:
+    explicit BackingStore(const std::string& filename);
+    ~BackingStore();
+
+    BackingStore(const BackingStore&) = delete;
+    BackingStore& operator=(const BackingStore&) = delete;
+
+    bool isOpen() const;
+    // Fills buffer with size bytes from offset. Bytes past the end of the
+    // file read as zero. Returns false on an I/O error.
+    bool readAt(long long offset, char* buffer, size_t size);
+    bool writeAt(long long offset, const char* buffer, size_t size);
+};
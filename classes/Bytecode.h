@@ -0,0 +1,80 @@
+// Bytecode.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Process programs are lowered once, when the process is created, into a
+// flat array of fixed-size instructions that Process::runInstructionSlice
+// walks with a switch. Operands are resolved in place: immediates are stored
+// inline, variables as indices into the program's name pool, and FOR bodies
+// become a LOOP_BEGIN/LOOP_END pair around the inlined body.
+
+enum class OpCode : uint8_t {
+    PRINT_HELLO,        // "Hello world from <process>"
+    PRINT_MESSAGE,      // strings[arg]
+    PRINT_VAR,          // "<a> = <value of a>"
+    PRINT_COMBINED,     // strings[arg] + value of a
+    DECLARE,            // dst = arg
+    ADD,                // dst = a + b
+    SUBTRACT,           // dst = a - b
+    SLEEP,              // sleep for arg ticks
+    LOOP_BEGIN,         // repeat the body arg times; target = matching LOOP_END
+    LOOP_END,           // target = first body instruction
+    READ,               // dst = memory[arg]
+    WRITE,              // memory[arg] = a
+    UNKNOWN             // strings[arg] = reason
+};
+
+// flags
+const uint8_t OPERAND_A_IMM = 1;    // a is a value, not a name index
+const uint8_t OPERAND_B_IMM = 2;    // b is a value, not a name index
+const uint8_t RETIRES_LINE = 4;     // completing this op completes a top-level instruction
+
+struct Instr {
+    OpCode op;
+    uint8_t flags = 0;
+    uint16_t dst = 0;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    uint32_t arg = 0;
+    uint32_t target = 0;
+};
+
+struct Bytecode {
+    std::vector<Instr> code;
+    std::vector<std::string> names;     // interned variable names
+    std::vector<std::string> strings;   // PRINT literals, UNKNOWN reasons
+
+    uint16_t internName(const std::string& name) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) return (uint16_t)i;
+        }
+        names.push_back(name);
+        return (uint16_t)(names.size() - 1);
+    }
+
+    uint32_t internString(const std::string& text) {
+        strings.push_back(text);
+        return (uint32_t)(strings.size() - 1);
+    }
+
+    size_t emit(const Instr& instr) {
+        code.push_back(instr);
+        return code.size() - 1;
+    }
+
+    // Called after each top-level ICommand is compiled.
+    void endLine() {
+        if (!code.empty()) code.back().flags |= RETIRES_LINE;
+    }
+};
+
+// What one call to Process::runInstructionSlice did.
+struct SliceResult {
+    unsigned int retired = 0;   // top-level instructions completed
+    int fault_page = -1;        // page that must be brought in before resuming, or -1
+    bool fault_write = false;   // the faulting access was a WRITE
+    unsigned int page_hits = 0; // ops whose page was already resident
+};
@@ -0,0 +1,145 @@
+// FlatAllocator.cpp
+#include "FlatAllocator.h"
+#include <algorithm>
+
+// Adjacent free blocks count as one hole.
+static void mergeHoles(std::vector<FlatAllocator::Hole>& holes) {
+    std::sort(holes.begin(), holes.end(),
+              [](const FlatAllocator::Hole& a, const FlatAllocator::Hole& b) { return a.start < b.start; });
+    size_t merged = 0;
+    for (size_t i = 0; i < holes.size(); ++i) {
+        if (merged > 0 && holes[merged - 1].start + holes[merged - 1].size == holes[i].start) {
+            holes[merged - 1].size += holes[i].size;
+        } else {
+            holes[merged++] = holes[i];
+        }
+    }
+    holes.resize(merged);
+}
+
+ListAllocator::ListAllocator(size_t num_units, bool best_fit)
+    : FlatAllocator(num_units), best_fit(best_fit) {
+    if (num_units > 0) holes[0] = num_units;
+}
+
+long long ListAllocator::allocate(size_t size) {
+    auto chosen = holes.end();
+    for (auto it = holes.begin(); it != holes.end(); ++it) {
+        if (it->second < size) continue;
+        if (chosen == holes.end() || it->second < chosen->second) chosen = it;
+        if (!best_fit || it->second == size) break;
+    }
+    if (chosen == holes.end()) return -1;
+
+    size_t start = chosen->first;
+    size_t left = chosen->second - size;
+    holes.erase(chosen);
+    if (left > 0) holes[start + size] = left;
+    return (long long)start;
+}
+
+void ListAllocator::release(size_t start, size_t size) {
+    auto it = holes.emplace(start, size).first;
+
+    auto next = std::next(it);
+    if (next != holes.end() && start + it->second == next->first) {
+        it->second += next->second;
+        holes.erase(next);
+    }
+    if (it != holes.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == start) {
+            prev->second += it->second;
+            holes.erase(it);
+        }
+    }
+}
+
+void ListAllocator::getHoles(std::vector<Hole>& out) const {
+    out.clear();
+    for (const auto& hole : holes) out.push_back({hole.first, hole.second});
+}
+
+void ListAllocator::resetTo(size_t used) {
+    holes.clear();
+    if (used < num_units) holes[used] = num_units - used;
+}
+
+size_t BuddyAllocator::orderOf(size_t size) {
+    size_t order = 0;
+    while (((size_t)1 << order) < size) order++;
+    return order;
+}
+
+BuddyAllocator::BuddyAllocator(size_t num_units) : FlatAllocator(num_units) {
+    free_lists.resize(orderOf(std::max<size_t>(num_units, 1)) + 1);
+    addInitialBlocks(0);
+}
+
+// Covers [from, num_units) with the largest aligned power-of-two blocks.
+void BuddyAllocator::addInitialBlocks(size_t from) {
+    size_t offset = from;
+    while (offset < num_units) {
+        size_t order = free_lists.size() - 1;
+        while ((offset & (((size_t)1 << order) - 1)) != 0 || offset + ((size_t)1 << order) > num_units) {
+            order--;
+        }
+        free_lists[order].insert(offset);
+        offset += (size_t)1 << order;
+    }
+}
+
+size_t BuddyAllocator::blockSize(size_t size) const {
+    return (size_t)1 << orderOf(size);
+}
+
+long long BuddyAllocator::allocate(size_t size) {
+    size_t order = orderOf(size);
+    size_t from = order;
+    while (from < free_lists.size() && free_lists[from].empty()) from++;
+    if (from >= free_lists.size()) return -1;
+
+    size_t start = *free_lists[from].begin();
+    free_lists[from].erase(free_lists[from].begin());
+    // Split down, keeping the low half and freeing the high one.
+    while (from > order) {
+        from--;
+        free_lists[from].insert(start + ((size_t)1 << from));
+    }
+    return (long long)start;
+}
+
+void BuddyAllocator::release(size_t start, size_t size) {
+    size_t order = orderOf(size);
+    while (order + 1 < free_lists.size()) {
+        size_t buddy = start ^ ((size_t)1 << order);
+        size_t merged = std::min(start, buddy);
+        if (merged + ((size_t)2 << order) > num_units) break;
+        auto it = free_lists[order].find(buddy);
+        if (it == free_lists[order].end()) break;
+        free_lists[order].erase(it);
+        start = merged;
+        order++;
+    }
+    free_lists[order].insert(start);
+}
+
+void BuddyAllocator::getHoles(std::vector<Hole>& out) const {
+    out.clear();
+    for (size_t order = 0; order < free_lists.size(); ++order) {
+        for (size_t start : free_lists[order]) out.push_back({start, (size_t)1 << order});
+    }
+    mergeHoles(out);
+}
+
+void BuddyAllocator::resetTo(size_t used) {
+    for (auto& list : free_lists) list.clear();
+    addInitialBlocks(used);
+}
+
+std::unique_ptr<FlatAllocator> makeFlatAllocator(const std::string& name, size_t num_units) {
+    if (name == "first-fit") return std::make_unique<ListAllocator>(num_units, false);
+    if (name == "best-fit") return std::make_unique<ListAllocator>(num_units, true);
+    if (name == "buddy") return std::make_unique<BuddyAllocator>(num_units);
+    return nullptr;
+}
@@ -0,0 +1,82 @@
+// FlatAllocator.h
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// Contiguous allocation for memory-mode flat. Memory is handed out in
+// frame-sized units; a block is the unit range [start, start + size).
+// Not thread-safe: the MMU calls it under its flat-memory lock.
+class FlatAllocator {
+protected:
+    size_t num_units;
+
+public:
+    struct Hole {
+        size_t start;
+        size_t size;
+    };
+
+    explicit FlatAllocator(size_t num_units) : num_units(num_units) {}
+    virtual ~FlatAllocator() = default;
+
+    virtual std::string getName() const = 0;
+    // Units a request for size units actually takes.
+    virtual size_t blockSize(size_t size) const { return size; }
+    // Returns the start of a free block of blockSize(size) units, or -1.
+    virtual long long allocate(size_t size) = 0;
+    // Frees a block allocate returned, merging it with free neighbours.
+    virtual void release(size_t start, size_t size) = 0;
+    // Free blocks, lowest address first.
+    virtual void getHoles(std::vector<Hole>& holes) const = 0;
+    // Whether blocks may be moved to close up holes.
+    virtual bool canCompact() const { return false; }
+    // After compaction: [0, used) is allocated and the rest is one hole.
+    virtual void resetTo(size_t used) = 0;
+};
+
+// Free blocks kept in an address-ordered map, merged with their neighbours
+// on release. First fit takes the lowest hole that fits; best fit the
+// smallest, lowest first on a tie.
+class ListAllocator : public FlatAllocator {
+private:
+    std::map<size_t, size_t> holes;     // start -> size
+    bool best_fit;
+
+public:
+    ListAllocator(size_t num_units, bool best_fit);
+    std::string getName() const override { return best_fit ? "best-fit" : "first-fit"; }
+    long long allocate(size_t size) override;
+    void release(size_t start, size_t size) override;
+    void getHoles(std::vector<Hole>& out) const override;
+    bool canCompact() const override { return true; }
+    void resetTo(size_t used) override;
+};
+
+// Power-of-two buddy system. Memory that is not a power of two is split
+// into the largest aligned power-of-two blocks that fit, and buddies merge
+// only within those. Requests are rounded up, so the slack is internal
+// fragmentation; blocks must stay aligned, so there is no compaction.
+class BuddyAllocator : public FlatAllocator {
+private:
+    std::vector<std::set<size_t>> free_lists;   // by order, lowest address first
+
+    static size_t orderOf(size_t size);
+    void addInitialBlocks(size_t from);
+
+public:
+    explicit BuddyAllocator(size_t num_units);
+    std::string getName() const override { return "buddy"; }
+    size_t blockSize(size_t size) const override;
+    long long allocate(size_t size) override;
+    void release(size_t start, size_t size) override;
+    void getHoles(std::vector<Hole>& out) const override;
+    void resetTo(size_t used) override;
+};
+
+// Returns nullptr for an unknown name.
+std::unique_ptr<FlatAllocator> makeFlatAllocator(const std::string& name, size_t num_units);
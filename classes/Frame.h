@@ -1,19 +1,38 @@
 #pragma once
 
+class PageTable;
+
 struct Frame {
     bool is_free = true;
     int owner_pid = -1;      
     int page_number = -1;  
+    // Reverse mapping: the page table whose page_number entry points here.
+    // Valid while the frame is in use; a process's frames are all released
+    // before the process (and its page table) can be destroyed.
+    PageTable* owner_table = nullptr;
+    bool in_transit = false;            // taken by a fault that is still filling it; not evictable
+    bool cleaned_ahead = false;         // the daemon cleaned this page before it was picked as a victim
+    // Links in the owning process's resident frame list (head in its PageTable).
+    int prev_resident = -1;
+    int next_resident = -1;
     
-    void assign(int pid, int page_num) {
+    void assign(int pid, int page_num, PageTable* table) {
         is_free = false;
+        in_transit = false;
         owner_pid = pid;
         page_number = page_num;
+        owner_table = table;
+        cleaned_ahead = false;
     }
 
     void reset() {
         is_free = true;
+        in_transit = false;
         owner_pid = -1;
         page_number = -1;
+        owner_table = nullptr;
+        cleaned_ahead = false;
+        prev_resident = -1;
+        next_resident = -1;
     }
 };
\ No newline at end of file
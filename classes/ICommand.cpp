@@ -22,30 +22,24 @@ PRINT::PRINT(const std::string& msg, const std::string& varName)
       isCombined(true)  // It's the special combined case
 {}
 
-void PRINT::execute(Process& process) {
-
-    std::string messageContent;
-    // Combined must be checked first and exclusively: it also sets isVariable,
-    // so a plain "if" here would let the next branch overwrite the result.
+void PRINT::compile(Bytecode& out) const {
+    Instr instr;
+    // Combined must be checked first and exclusively: it also sets isVariable.
     if (isCombined) {
-        uint16_t value = process.getVariableValue(variableName);
-        messageContent = message + std::to_string(value);
+        instr.op = OpCode::PRINT_COMBINED;
+        instr.arg = out.internString(message);
+        instr.a = out.internName(variableName);
     } else if (isVariable && !variableName.empty()) {
-        uint16_t value = process.getVariableValue(variableName);
-        messageContent = variableName + " = " + std::to_string(value);
+        instr.op = OpCode::PRINT_VAR;
+        instr.a = out.internName(variableName);
     } else if (!message.empty()) {
-        messageContent = message;
+        instr.op = OpCode::PRINT_MESSAGE;
+        instr.arg = out.internString(message);
     } else {
-        messageContent = "Hello world from " + process.getProcessName();
+        instr.op = OpCode::PRINT_HELLO;
     }
-
-
-    std::string log = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-        std::to_string(process.getCurrentCoreId()) + ", " + messageContent;
-    
-    process.addLog(log);
+    out.emit(instr);
 }
-
 std::string PRINT::toString(const Process& process) const {
     if (isVariable) {
         return "PRINT variable \"" + variableName + "\"";
@@ -58,13 +52,13 @@ std::string PRINT::toString(const Process& process) const {
 DECLARE::DECLARE(const std::string& varName, uint16_t val)
     : variableName(varName), value(val) {}
 
-void DECLARE::execute(Process& process) {
-    process.setVariable(variableName, value);
-    std::string log = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + std::to_string(process.getCurrentCoreId()) + ", "
-                    + "Declared " + variableName + " = " + std::to_string(value);
-    process.addLog(log);
+void DECLARE::compile(Bytecode& out) const {
+    Instr instr;
+    instr.op = OpCode::DECLARE;
+    instr.dst = out.internName(variableName);
+    instr.arg = value;
+    out.emit(instr);
 }
-
 int DECLARE::getRequiredPage(size_t page_size) {
     return 0; 
 }
@@ -90,24 +84,33 @@ ADD::ADD(const std::string& var1, uint16_t value1, uint16_t value2)
     : resultVar(var1), operand1Var(""), operand2Var(""),
       operand1Value(value1), operand2Value(value2), operand1IsVar(false), operand2IsVar(false) {}
 
-void ADD::execute(Process& process) {
-    uint16_t op1 = operand1IsVar ? process.getVariableValue(operand1Var) : operand1Value;
-    uint16_t op2 = operand2IsVar ? process.getVariableValue(operand2Var) : operand2Value;
-
-    uint32_t result = static_cast<uint32_t>(op1) + static_cast<uint32_t>(op2);
-    uint16_t finalResult = std::min(result, static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()));
-
-    process.setVariable(resultVar, finalResult);
-
-    std::string log = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-                    std::to_string(process.getCurrentCoreId()) + ", "
-                    + resultVar + " = " + std::to_string(op1) 
-                    + " + " + std::to_string(op2) 
-                    + " = " + std::to_string(finalResult);
-    
-    process.addLog(log);
+// Shared by ADD and SUBTRACT: dst = a <op> b, each operand a variable or an immediate.
+static void compileArithmetic(Bytecode& out, OpCode op, const std::string& resultVar,
+                              bool operand1IsVar, const std::string& operand1Var, uint16_t operand1Value,
+                              bool operand2IsVar, const std::string& operand2Var, uint16_t operand2Value) {
+    Instr instr;
+    instr.op = op;
+    instr.dst = out.internName(resultVar);
+    if (operand1IsVar) {
+        instr.a = out.internName(operand1Var);
+    } else {
+        instr.a = operand1Value;
+        instr.flags |= OPERAND_A_IMM;
+    }
+    if (operand2IsVar) {
+        instr.b = out.internName(operand2Var);
+    } else {
+        instr.b = operand2Value;
+        instr.flags |= OPERAND_B_IMM;
+    }
+    out.emit(instr);
 }
 
+void ADD::compile(Bytecode& out) const {
+    compileArithmetic(out, OpCode::ADD, resultVar,
+                      operand1IsVar, operand1Var, operand1Value,
+                      operand2IsVar, operand2Var, operand2Value);
+}
 std::string ADD::toString(const Process& process) const {
     auto a = operand1IsVar ? operand1Var : std::to_string(operand1Value);
     auto b = operand2IsVar ? operand2Var : std::to_string(operand2Value);
@@ -131,23 +134,11 @@ SUBTRACT::SUBTRACT(const std::string& var1, uint16_t value1, uint16_t value2)
     : resultVar(var1), operand1Var(""), operand2Var(""),
       operand1Value(value1), operand2Value(value2), operand1IsVar(false), operand2IsVar(false) {}
 
-void SUBTRACT::execute(Process& process) {
-    uint16_t op1 = operand1IsVar ? process.getVariableValue(operand1Var) : operand1Value;
-    uint16_t op2 = operand2IsVar ? process.getVariableValue(operand2Var) : operand2Value;
-
-    uint16_t result = (op1 >= op2) ? (op1 - op2) : 0;
-
-    process.setVariable(resultVar, result);
-
-    std::string log = "[Process " + process.getProcessName() + "] " 
-                    + get_timestamp() + " Core ID: " + std::to_string(process.getCurrentCoreId()) + ", "
-                    + resultVar + " = " + std::to_string(op1) 
-                    + " - " + std::to_string(op2) 
-                    + " = " + std::to_string(result);
-
-    process.addLog(log);
+void SUBTRACT::compile(Bytecode& out) const {
+    compileArithmetic(out, OpCode::SUBTRACT, resultVar,
+                      operand1IsVar, operand1Var, operand1Value,
+                      operand2IsVar, operand2Var, operand2Value);
 }
-
 std::string SUBTRACT::toString(const Process& process) const {
     auto a = operand1IsVar ? operand1Var : std::to_string(operand1Value);
     auto b = operand2IsVar ? operand2Var : std::to_string(operand2Value);
@@ -157,18 +148,12 @@ std::string SUBTRACT::toString(const Process& process) const {
 // ----- SLEEP -----
 SLEEP::SLEEP(uint8_t ticks) : cpuTicks(ticks) {}
 
-void SLEEP::execute(Process& process) {
-    std::string startLog = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-        std::to_string(process.getCurrentCoreId()) + ", " + "Sleeping for " + std::to_string(cpuTicks) + " CPU ticks";
-    process.addLog(startLog);
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(cpuTicks * 10));
-
-    std::string endLog = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-        std::to_string(process.getCurrentCoreId()) + ", " + "Woke up from sleep";
-    process.addLog(endLog);
+void SLEEP::compile(Bytecode& out) const {
+    Instr instr;
+    instr.op = OpCode::SLEEP;
+    instr.arg = cpuTicks;
+    out.emit(instr);
 }
-
 std::string SLEEP::toString(const Process& process) const {
     return "SLEEP " + std::to_string(cpuTicks) + " ticks";
 }
@@ -177,21 +162,29 @@ std::string SLEEP::toString(const Process& process) const {
 FOR::FOR(std::vector<std::unique_ptr<ICommand>>&& instrs, uint8_t repeats)
     : instructions(std::move(instrs)), repeatCount(repeats) {}
 
-void FOR::execute(Process& process) {
-    std::string startLog = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-        std::to_string(process.getCurrentCoreId()) + ", " + "Starting FOR loop (" + std::to_string(repeatCount) + " iterations)";
-    process.addLog(startLog);
-    for (uint8_t i = 0; i < repeatCount; ++i) {
-        for (auto& instruction : instructions) {
-            instruction->execute(process);
-        }
+void FOR::compile(Bytecode& out) const {
+    Instr begin;
+    begin.op = OpCode::LOOP_BEGIN;
+    begin.arg = repeatCount;
+    size_t begin_index = out.emit(begin);
+
+    for (const auto& instruction : instructions) {
+        instruction->compile(out);
     }
 
-    std::string endLog = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-        std::to_string(process.getCurrentCoreId()) + ", " + "FOR loop completed";
-    process.addLog(endLog);
+    Instr end;
+    end.op = OpCode::LOOP_END;
+    end.target = (uint32_t)(begin_index + 1);
+    size_t end_index = out.emit(end);
+    out.code[begin_index].target = (uint32_t)end_index;
+}
+std::unique_ptr<ICommand> FOR::clone() const {
+    std::vector<std::unique_ptr<ICommand>> body;
+    for (const auto& instr : instructions) {
+        body.push_back(instr->clone());
+    }
+    return std::make_unique<FOR>(std::move(body), repeatCount);
 }
-
 std::string FOR::toString(const Process& process) const {
     std::string instrsStr;
     instrsStr.reserve(instructions.size() * 20);  // optional: avoid a few reallocs
@@ -215,26 +208,13 @@ std::string FOR::toString(const Process& process) const {
 READ::READ(const std::string& var, uint32_t address)
     : variable_name(var), memory_address(address) {}
 
-void READ::execute(Process& process) {
-    // 1. ACCESS VIOLATION CHECK: Is the address within the process's allocated memory?
-    if (memory_address >= process.getMemorySize()) {
-        std::stringstream ss;
-        ss << "Access violation at 0x" << std::hex << memory_address << ".";
-        process.terminate(ss.str()); // Terminate the process
-        return; // Stop execution immediately
-    }
-
-
-    uint16_t value_read = process.readMemory(memory_address);
-    
-    process.setVariable(variable_name, value_read);
-
-    std::string log = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-    std::to_string(process.getCurrentCoreId()) + ", " + "Read value " + 
-    std::to_string(value_read) + " from 0x" + std::to_string(memory_address) + " into " + variable_name;
-    process.addLog(log);
+void READ::compile(Bytecode& out) const {
+    Instr instr;
+    instr.op = OpCode::READ;
+    instr.dst = out.internName(variable_name);
+    instr.arg = memory_address;
+    out.emit(instr);
 }
-
 std::string READ::toString(const Process& process) const {
     std::stringstream ss;
     ss << "READ " << variable_name << " 0x" << std::hex << memory_address;
@@ -246,28 +226,13 @@ std::string READ::toString(const Process& process) const {
 WRITE::WRITE(const std::string& var, uint32_t address)
     : variable_name(var), memory_address(address) {}
 
-void WRITE::execute(Process& process) {
-    // 1. ACCESS VIOLATION CHECK:
-    if (memory_address >= process.getMemorySize()) {
-        std::stringstream ss;
-        ss << "Access violation at 0x" << std::hex << memory_address << ".";
-        
-        process.terminate(ss.str());
-        return;
-    }
-
-    uint16_t value_to_write = 0; 
-    process.getVariable(variable_name, value_to_write);
-    process.writeMemory(memory_address, value_to_write);
-    int page_number = getRequiredPage(process.getPageTable()->getPageSize());
-    process.getPageTable()->setDirty(page_number, true);
-
-    std::string log = "[Process " + process.getProcessName() + "] " + get_timestamp() + " Core ID: " + 
-    std::to_string(process.getCurrentCoreId()) + ", " + "Wrote value " + 
-    std::to_string(value_to_write) + " (from " + variable_name + ") to 0x" + std::to_string(memory_address);
-    process.addLog(log);
+void WRITE::compile(Bytecode& out) const {
+    Instr instr;
+    instr.op = OpCode::WRITE;
+    instr.a = out.internName(variable_name);
+    instr.arg = memory_address;
+    out.emit(instr);
 }
-
 std::string WRITE::toString(const Process& process) const {
     uint16_t value = 0;
     process.getVariable(variable_name, value);
@@ -291,11 +256,12 @@ UNKNOWN::UNKNOWN()
 UNKNOWN::UNKNOWN(const std::string& reasonMessage) 
     : reason(reasonMessage) {}
 
-void UNKNOWN::execute(Process& process) {
-    std::cerr << "[Process " << process.getProcessName() << "] "
-              << "ERROR: Unknown command encountered. Reason: " << reason << std::endl;
+void UNKNOWN::compile(Bytecode& out) const {
+    Instr instr;
+    instr.op = OpCode::UNKNOWN;
+    instr.arg = out.internString(reason);
+    out.emit(instr);
 }
-
 std::string UNKNOWN::toString(const Process& process) const {
     return "UNKNOWN command: " + reason;
 }
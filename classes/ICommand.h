@@ -3,14 +3,20 @@
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include "Bytecode.h"
 
 class Process; // Forward declaration to avoid circular include
 
+// Front end for process programs. Commands are not executed directly: each
+// one lowers itself into the process's Bytecode when it is added, and
+// toString() is kept for displaying the program.
 class ICommand {
 public:
     virtual ~ICommand() = default;
-    virtual void execute(Process& process) = 0;
+    virtual void compile(Bytecode& out) const = 0;
     virtual std::string toString(const Process& process) const = 0; 
+    // Deep copy, for forking a process.
+    virtual std::unique_ptr<ICommand> clone() const = 0;
 };
 
 // ========== Concrete Commands ========== //
@@ -28,8 +34,9 @@ public:
     PRINT(const std::string& msg, bool isMsg); // print custom message
     PRINT(const std::string& msg, const std::string& varName);
 
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<PRINT>(*this); }
 };
 
 class DECLARE : public ICommand {
@@ -39,8 +46,9 @@ private:
 
 public:
     DECLARE(const std::string& varName, uint16_t val);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<DECLARE>(*this); }
     int getRequiredPage(size_t page_size);
 };
 
@@ -60,8 +68,9 @@ public:
     ADD(const std::string& var1, uint16_t value, const std::string& var3);
     ADD(const std::string& var1, uint16_t value1, uint16_t value2);
     static int getRequiredPage(size_t page_size) { return 0; }
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<ADD>(*this); }
 };
 
 class SUBTRACT : public ICommand {
@@ -80,8 +89,9 @@ public:
     SUBTRACT(const std::string& var1, uint16_t value, const std::string& var3);
     SUBTRACT(const std::string& var1, uint16_t value1, uint16_t value2);
     static int getRequiredPage(size_t page_size) { return 0; }
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<SUBTRACT>(*this); }
 };
 
 class SLEEP : public ICommand {
@@ -90,8 +100,9 @@ private:
 
 public:
     SLEEP(uint8_t ticks);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<SLEEP>(*this); }
 };
 
 class FOR : public ICommand {
@@ -101,8 +112,9 @@ private:
 
 public:
     FOR(std::vector<std::unique_ptr<ICommand>>&& instrs, uint8_t repeats);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override;
 };
 
 class READ : public ICommand {
@@ -112,8 +124,9 @@ private:
 
 public:
     READ(const std::string& var, uint32_t address);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<READ>(*this); }
     uint32_t getAddress() const { return memory_address; }
     int getRequiredPage(size_t page_size) const;
 };
@@ -126,8 +139,9 @@ private:
 
 public:
     WRITE(const std::string& var, uint32_t address);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<WRITE>(*this); }
     uint32_t getAddress() const { return memory_address; }
 
     int getRequiredPage(size_t page_size) const;
@@ -140,7 +154,8 @@ private:
 public:
     UNKNOWN();
     UNKNOWN(const std::string& reasonMessage);
-    void execute(Process& process) override;
+    void compile(Bytecode& out) const override;
     std::string toString(const Process& process) const override;
+    std::unique_ptr<ICommand> clone() const override { return std::make_unique<UNKNOWN>(*this); }
 };
 
@@ -0,0 +1,99 @@
+// LogArchive.cpp
+#include "LogArchive.h"
+#include <iostream>
+#include <algorithm>
+
+LogArchive::LogArchive(const std::string& filename, size_t ring_capacity)
+    : filename(filename), ring_capacity(ring_capacity) {
+    file.open(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[Logs] WARNING: Could not open " << filename
+                  << "; process logs will not be archived." << std::endl;
+    }
+}
+
+void LogArchive::spill(int pid, uint64_t first, const LogRecord* records, size_t count) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    if (!file.is_open()) return;
+
+    file.seekp(file_size);
+    file.write(reinterpret_cast<const char*>(records), count * sizeof(LogRecord));
+
+    // Consecutive spills of one process usually land back to back; merge them.
+    auto& extents = index[pid];
+    if (!extents.empty() &&
+        extents.back().offset + extents.back().count * sizeof(LogRecord) == file_size &&
+        extents.back().first + extents.back().count == first) {
+        extents.back().count += count;
+    } else {
+        extents.push_back({file_size, first, count});
+    }
+    file_size += count * sizeof(LogRecord);
+}
+
+std::vector<LogRecord> LogArchive::read(int pid, uint64_t first, size_t count) {
+    std::vector<LogRecord> records;
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    auto it = index.find(pid);
+    if (it == index.end() || !file.is_open()) return records;
+
+    file.flush();
+    for (const auto& extent : it->second) {
+        if (records.size() == count) break;
+        uint64_t end = extent.first + extent.count;
+        if (first >= end) continue;
+
+        uint64_t start = std::max(first, extent.first);
+        size_t n = (size_t)std::min<uint64_t>(end - start, count - records.size());
+        size_t old_size = records.size();
+        records.resize(old_size + n);
+        file.seekg(extent.offset + (start - extent.first) * sizeof(LogRecord));
+        file.read(reinterpret_cast<char*>(records.data() + old_size), n * sizeof(LogRecord));
+        first = start + n;
+    }
+    file.clear();
+    return records;
+}
+
+void LogArchive::spillNote(int pid, const std::string& text) {
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    if (!file.is_open()) return;
+
+    file.seekp(file_size);
+    file.write(text.data(), text.size());
+    notes[pid].push_back({file_size, (uint32_t)text.size()});
+    file_size += text.size();
+}
+
+std::string LogArchive::readNote(int pid, uint32_t note) {
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    auto it = notes.find(pid);
+    if (it == notes.end() || note >= it->second.size() || !file.is_open()) return "";
+
+    const Note& where = it->second[note];
+    std::string text(where.length, '\0');
+    file.flush();
+    file.seekg(where.offset);
+    file.read(&text[0], text.size());
+    file.clear();
+    return text;
+}
+
+uint64_t LogArchive::archivedCount(int pid) const {
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    auto it = index.find(pid);
+    if (it == index.end()) return 0;
+    uint64_t total = 0;
+    for (const auto& extent : it->second) total += extent.count;
+    return total;
+}
+
+size_t LogArchive::getRingCapacity() const {
+    return ring_capacity;
+}
+
+uint64_t LogArchive::getFileSize() const {
+    std::lock_guard<std::mutex> lock(archive_mutex);
+    return file_size;
+}
@@ -0,0 +1,51 @@
+// LogArchive.h
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LogRecord.h"
+
+// Append-only, per-run file that holds the log records processes have
+// evicted from their in-memory ring buffers, indexed by PID so a screen can
+// page back through a process's whole history.
+class LogArchive {
+private:
+    struct Extent {
+        uint64_t offset;    // byte offset in the file
+        uint64_t first;     // index of the first record in the process's log
+        uint64_t count;
+    };
+
+    std::fstream file;
+    std::string filename;
+    uint64_t file_size = 0;
+    size_t ring_capacity;
+    std::unordered_map<int, std::vector<Extent>> index;
+    // Where each archived NOTE's text is, by pid and note number.
+    struct Note {
+        uint64_t offset;
+        uint32_t length;
+    };
+    std::unordered_map<int, std::vector<Note>> notes;
+    mutable std::mutex archive_mutex;
+
+public:
+    LogArchive(const std::string& filename, size_t ring_capacity);
+
+    // Appends count records of pid's log, which are entries first..first+count-1.
+    void spill(int pid, uint64_t first, const LogRecord* records, size_t count);
+    // Reads up to count archived records of pid starting at log index first.
+    std::vector<LogRecord> read(int pid, uint64_t first, size_t count);
+    uint64_t archivedCount(int pid) const;
+    // Appends the text of pid's next note; notes are archived in order.
+    void spillNote(int pid, const std::string& text);
+    // Text of pid's archived note number note, or "" if it is not there.
+    std::string readNote(int pid, uint32_t note);
+
+    size_t getRingCapacity() const;
+    uint64_t getFileSize() const;
+};
@@ -0,0 +1,26 @@
+// LogRecord.h
+#pragma once
+
+#include <cstdint>
+#include "Bytecode.h"
+
+enum class LogKind : uint8_t {
+    INSTRUCTION,    // an executed op; details come from bytecode.code[ip]
+    LOOP_DONE,      // the LOOP_END at ip let its loop exit
+    WOKE_UP,        // first run after a SLEEP
+    NOTE            // free text; ip is the note number, see Process::log_notes
+};
+
+// One process log entry. The interpreter appends these on the hot path;
+// Process::renderLog turns one into text only when a screen displays it.
+struct LogRecord {
+    uint64_t tick;          // g_cpu_tick when logged
+    int64_t wall_time;      // std::time() when logged, 0 in turbo mode
+    uint32_t ip;            // bytecode index of the op, or note index
+    int16_t core_id;
+    LogKind kind;
+    OpCode op;
+    uint16_t operand1;      // value of the first operand, where it had one
+    uint16_t operand2;      // value of the second operand
+    uint16_t result;        // value produced, read or written
+};
@@ -0,0 +1,216 @@
+// MemoryJournal.cpp
+#include "MemoryJournal.h"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+MemoryJournal::MemoryJournal(const std::string& filename, size_t num_frames, size_t frame_size, size_t num_buckets)
+    : filename(filename), num_frames((uint32_t)num_frames), frame_size((uint32_t)frame_size),
+      seal_owners(num_frames, -1), seal_marks(num_frames, 0) {
+    for (size_t i = 0; i < std::max<size_t>(1, num_buckets); ++i) {
+        buckets.push_back(std::make_unique<Bucket>());
+    }
+    file.open(filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[Memory] WARNING: Could not open " << filename
+                  << "; memory stamps will not be available." << std::endl;
+    } else {
+        FileHeader header = {{'C', 'S', 'M', 'J'}, this->num_frames, this->frame_size, 0};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    writer_thread = std::thread(&MemoryJournal::writer, this);
+}
+
+MemoryJournal::~MemoryJournal() {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        writer_stop = true;
+    }
+    writer_cv.notify_all();
+    if (writer_thread.joinable()) writer_thread.join();
+}
+
+void MemoryJournal::record(size_t bucket, size_t first_frame, size_t count, int pid) {
+    if (count == 0) return;
+    Bucket& target = *buckets[bucket % buckets.size()];
+    std::lock_guard<std::mutex> lock(target.mutex);
+    // A block recorded in pieces makes one delta.
+    if (!target.pending.empty()) {
+        Delta& last = target.pending.back();
+        if (last.pid == pid && last.first_frame + last.count == first_frame) {
+            last.count += (uint32_t)count;
+            return;
+        }
+    }
+    target.pending.push_back({(uint32_t)first_frame, (uint32_t)count, (int32_t)pid});
+}
+
+// Buckets never share a frame, so applying them one after another leaves
+// each frame's last change; the quantum is written as the runs those form.
+void MemoryJournal::seal(uint64_t quantum, uint64_t tick, int64_t wall_time) {
+    last_quantum = quantum;
+    seals++;
+    std::vector<uint32_t> touched;
+    std::vector<Delta> deltas;
+    for (auto& bucket : buckets) {
+        {
+            std::lock_guard<std::mutex> lock(bucket->mutex);
+            deltas.swap(bucket->pending);
+        }
+        for (const Delta& delta : deltas) {
+            for (uint32_t f = delta.first_frame; f < delta.first_frame + delta.count && f < num_frames; ++f) {
+                if (seal_marks[f] != seals) {
+                    seal_marks[f] = seals;
+                    touched.push_back(f);
+                }
+                seal_owners[f] = delta.pid;
+            }
+        }
+        deltas.clear();
+    }
+    if (touched.empty()) return;
+
+    std::sort(touched.begin(), touched.end());
+    Sealed next;
+    for (uint32_t f : touched) {
+        if (!next.deltas.empty()) {
+            Delta& last = next.deltas.back();
+            if (last.pid == seal_owners[f] && last.first_frame + last.count == f) {
+                last.count++;
+                continue;
+            }
+        }
+        next.deltas.push_back({f, 1, seal_owners[f]});
+    }
+    next.header = {quantum, tick, wall_time, (uint32_t)next.deltas.size(), 0};
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        sealed.push_back(std::move(next));
+    }
+    writer_cv.notify_one();
+}
+
+// Appends sealed quanta in order until told to stop, then drains.
+void MemoryJournal::writer() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    while (true) {
+        writer_cv.wait(lock, [&] { return !sealed.empty() || writer_stop; });
+        if (sealed.empty()) break;
+
+        Sealed next = std::move(sealed.front());
+        sealed.pop_front();
+        writing = true;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> file_lock(file_mutex);
+            if (file.is_open()) {
+                file.seekp(0, std::ios::end);
+                file.write(reinterpret_cast<const char*>(&next.header), sizeof(next.header));
+                file.write(reinterpret_cast<const char*>(next.deltas.data()), next.deltas.size() * sizeof(Delta));
+            }
+        }
+        lock.lock();
+        writing = false;
+        if (sealed.empty()) drained_cv.notify_all();
+    }
+}
+
+void MemoryJournal::waitForWriter() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    drained_cv.wait(lock, [&] { return sealed.empty() && !writing; });
+}
+
+template <typename Visit>
+void MemoryJournal::replay(uint64_t quantum, std::vector<int32_t>& owners, Visit visit) {
+    owners.assign(num_frames, -1);
+    waitForWriter();
+    std::lock_guard<std::mutex> lock(file_mutex);
+    if (!file.is_open()) return;
+
+    file.flush();
+    file.seekg(sizeof(FileHeader));
+    QuantumHeader header;
+    std::vector<Delta> deltas;
+    while (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.quantum <= quantum) {
+        deltas.resize(header.count);
+        if (!file.read(reinterpret_cast<char*>(deltas.data()), deltas.size() * sizeof(Delta))) break;
+        for (const Delta& delta : deltas) {
+            for (uint32_t f = delta.first_frame; f < delta.first_frame + delta.count && f < num_frames; ++f) {
+                owners[f] = delta.pid;
+            }
+        }
+        visit(header);
+    }
+    file.clear();
+}
+
+// The Week-10 layout: header lines, then each run of frames held by one
+// process from the top of memory down, as upper limit, name, lower limit.
+bool MemoryJournal::writeStamp(uint64_t quantum, const QuantumHeader& header, const std::vector<int32_t>& owners) {
+    std::ostringstream name;
+    name << "memory_stamp_" << std::setw(2) << std::setfill('0') << quantum << ".txt";
+    std::ofstream out(name.str());
+    if (!out.is_open()) {
+        std::cerr << "[Memory] Could not write " << name.str() << std::endl;
+        return false;
+    }
+
+    std::set<int32_t> resident;
+    size_t free_frames = 0;
+    for (int32_t pid : owners) {
+        if (pid < 0) {
+            free_frames++;
+        } else {
+            resident.insert(pid);
+        }
+    }
+
+    if (header.wall_time != 0) {
+        std::time_t when = (std::time_t)header.wall_time;
+        char buffer[64];
+        std::strftime(buffer, sizeof(buffer), "%m/%d/%Y %I:%M:%S%p", std::localtime(&when));
+        out << "Timestamp: (" << buffer << ")\n";
+    } else {
+        out << "Timestamp: (virtual tick " << header.tick << ")\n";
+    }
+    out << "Number of processes in memory: " << resident.size() << "\n";
+    out << "Total external fragmentation in KB: " << free_frames * frame_size / 1024.0 << "\n\n";
+
+    size_t total = (size_t)num_frames * frame_size;
+    out << "----end---- = " << total << "\n\n";
+    size_t top = owners.size();
+    while (top > 0) {
+        int32_t pid = owners[top - 1];
+        size_t bottom = top - 1;
+        while (bottom > 0 && owners[bottom - 1] == pid) bottom--;
+        if (pid >= 0) {
+            out << top * frame_size << "\n" << "P" << pid << "\n" << bottom * frame_size << "\n\n";
+        }
+        top = bottom;
+    }
+    out << "----start----- = 0\n";
+    return true;
+}
+
+uint64_t MemoryJournal::getLastQuantum() {
+    return last_quantum.load();
+}
+
+bool MemoryJournal::renderStamp(uint64_t quantum) {
+    std::vector<int32_t> owners;
+    QuantumHeader last = {};
+    replay(quantum, owners, [&](const QuantumHeader& header) { last = header; });
+    return writeStamp(quantum, last, owners);
+}
+
+size_t MemoryJournal::renderAllStamps() {
+    std::vector<int32_t> owners;
+    size_t written = 0;
+    replay(UINT64_MAX, owners, [&](const QuantumHeader& header) {
+        if (writeStamp(header.quantum, header, owners)) written++;
+    });
+    return written;
+}
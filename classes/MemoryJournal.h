@@ -0,0 +1,116 @@
+// MemoryJournal.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Append-only record of who owns which frame, one entry per quantum cycle,
+// from which the memory_stamp_<qq>.txt reports are rendered on demand.
+// The MMU reports each ownership change as it happens into one of several
+// buckets, so cores changing different frames do not meet on one lock;
+// seal() merges the buckets into the quantum's net changes and hands them
+// to a writer thread, so neither the cores nor the clock ever wait on the
+// file. Quanta with no changes are not written; a stamp for one shows the
+// state the last change left.
+//
+// File layout: a FileHeader, then per sealed quantum a QuantumHeader
+// followed by its count Deltas, applied in order.
+class MemoryJournal {
+public:
+    struct FileHeader {
+        char magic[4];          // "CSMJ"
+        uint32_t num_frames;
+        uint32_t frame_size;
+        uint32_t reserved;
+    };
+
+    struct QuantumHeader {
+        uint64_t quantum;
+        uint64_t tick;          // tick the quantum ended at
+        int64_t wall_time;      // std::time() when sealed, 0 in turbo mode
+        uint32_t count;         // deltas that follow
+        uint32_t reserved;
+    };
+
+    // Frames [first_frame, first_frame + count) now belong to pid, or are
+    // free if pid is -1.
+    struct Delta {
+        uint32_t first_frame;
+        uint32_t count;
+        int32_t pid;
+    };
+
+private:
+    struct Sealed {
+        QuantumHeader header;
+        std::vector<Delta> deltas;
+    };
+
+    std::string filename;
+    uint32_t num_frames;
+    uint32_t frame_size;
+
+    // Changes in the open quantum. Only deltas in one bucket are ordered.
+    struct Bucket {
+        std::mutex mutex;
+        std::vector<Delta> pending;
+    };
+    std::vector<std::unique_ptr<Bucket>> buckets;
+
+    // seal()'s scratch: each frame's owner as of the newest delta seen, and
+    // the seal that last touched it.
+    std::vector<int32_t> seal_owners;
+    std::vector<uint64_t> seal_marks;
+    uint64_t seals = 0;
+
+    std::mutex writer_mutex;
+    std::condition_variable writer_cv;      // wakes the writer
+    std::condition_variable drained_cv;     // wakes whoever waits for the writer
+    std::deque<Sealed> sealed;
+    bool writing = false;
+    bool writer_stop = false;
+    std::thread writer_thread;
+
+    std::mutex file_mutex;
+    std::fstream file;
+    std::atomic<uint64_t> last_quantum{0};  // newest quantum sealed, empty or not
+
+    void writer();
+    void waitForWriter();
+    // Replays the file into owners (frame -> pid, -1 free) up to quantum,
+    // calling visit with each record's header once it is applied.
+    template <typename Visit>
+    void replay(uint64_t quantum, std::vector<int32_t>& owners, Visit visit);
+    bool writeStamp(uint64_t quantum, const QuantumHeader& header, const std::vector<int32_t>& owners);
+
+public:
+    MemoryJournal(const std::string& filename, size_t num_frames, size_t frame_size, size_t num_buckets);
+    ~MemoryJournal();
+
+    MemoryJournal(const MemoryJournal&) = delete;
+    MemoryJournal& operator=(const MemoryJournal&) = delete;
+
+    // Safe from any thread. Every change to a given frame must go to the
+    // same bucket, in the order the changes happen.
+    void record(size_t bucket, size_t first_frame, size_t count, int pid);
+    // Closes quantum: everything recorded since the last seal belongs to it.
+    // Only one thread may seal at a time.
+    void seal(uint64_t quantum, uint64_t tick, int64_t wall_time);
+
+    // Newest quantum sealed so far.
+    uint64_t getLastQuantum();
+    // Writes memory_stamp_<qq>.txt showing memory as of quantum qq.
+    // Returns false if the stamp file could not be written.
+    bool renderStamp(uint64_t quantum);
+    // Writes a stamp for every quantum in the file, in one pass. Returns
+    // how many were written.
+    size_t renderAllStamps();
+};
@@ -1,152 +1,1025 @@
 // MemoryManager.cpp
 #include "MemoryManager.h"
-#include <fstream>
 #include "process.h"       
 #include "Scheduler.cpp"    
 #include "PageTable.cpp"
+#include "BackingStore.cpp"
+#include "ReplacementPolicy.cpp"
+#include "FlatAllocator.cpp"
+#include "MemoryJournal.cpp"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 
-extern Scheduler* os_scheduler;
-
-MemoryManager::MemoryManager(size_t total_memory_size, size_t frame_size, size_t mem_per_proc) {
+MemoryManager::MemoryManager(size_t total_memory_size, size_t frame_size, const std::string& replacement_policy,
+                             const std::string& memory_mode, const std::string& flat_allocator_name,
+                             size_t compaction_threshold)
+    : backing_store(backing_store_filename) {
     if (frame_size == 0) {
         throw std::invalid_argument("Frame size cannot be zero.");
     }
     this->frame_size = frame_size;
-    this->max_process_memory = mem_per_proc;
     size_t num_frames = total_memory_size / frame_size;
+    if (num_frames > PageTable::MAX_FRAMES) {
+        throw std::invalid_argument("Too many frames for a page table entry to address.");
+    }
     physical_memory.resize(num_frames);
-    for (size_t i = 0; i < num_frames; ++i) {
-        free_frames.push_back(i);
+    physical_bytes.resize(num_frames * frame_size, 0);
+
+    // Frame f belongs to shard f % shard count, at local index f / shard count.
+    size_t num_shards = std::max<size_t>(1, std::min(MAX_SHARDS, num_frames / MIN_SHARD_FRAMES));
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        size_t shard_frames = (num_frames + num_shards - 1 - i) / num_shards;
+        shard->policy = makeReplacementPolicy(replacement_policy, shard_frames);
+        if (!shard->policy) {
+            throw std::invalid_argument("Unknown page replacement policy: " + replacement_policy);
+        }
+        shards.push_back(std::move(shard));
     }
+    replacement_name = replacement_policy;
 
-    std::ofstream backing_store(backing_store_filename, std::ios::trunc | std::ios::binary);
-    if (!backing_store.is_open()) {
-        std::cerr << "[MMU] WARNING: Could not clear backing store file on startup." << std::endl;
+    if (memory_mode == "flat") {
+        flat_allocator = makeFlatAllocator(flat_allocator_name, num_frames);
+        if (!flat_allocator) {
+            throw std::invalid_argument("Unknown flat allocator: " + flat_allocator_name);
+        }
+        flat = true;
+        flat_free_units = num_frames;
+        this->compaction_threshold = compaction_threshold;
+    } else if (memory_mode != "paging") {
+        throw std::invalid_argument("Unknown memory mode: " + memory_mode);
     }
-    backing_store.close();
 
+    // Pushed in reverse so frames are handed out lowest-first. Flat mode
+    // leaves the stack empty; its frames belong to the allocator.
+    free_next.reset(new std::atomic<int>[num_frames]);
+    for (size_t i = num_frames; i-- > 0 && !flat;) {
+        pushFreeFrame((int)i);
+    }
+
+    journal = std::make_unique<MemoryJournal>(journal_filename, num_frames, frame_size, num_shards);
+    clean_target = std::max<size_t>(1, num_frames / num_shards / 4);
+    readahead_max = std::min(READAHEAD_MAX, num_frames / 4);
+    writeback_thread = std::thread(&MemoryManager::writebackDaemon, this);
+}
+
+MemoryManager::~MemoryManager() {
+    {
+        std::lock_guard<std::mutex> lock(writeback_mutex);
+        writeback_stop = true;
+    }
+    writeback_cv.notify_all();
+    if (writeback_thread.joinable()) writeback_thread.join();
+}
+
+void MemoryManager::pushFreeFrame(int frame) {
+    uint64_t top = free_top.load();
+    uint64_t next_top;
+    do {
+        free_next[frame].store((int)(top & 0xFFFFFFFF) - 1);
+        next_top = (((top >> 32) + 1) << 32) | (uint64_t)(frame + 1);
+    } while (!free_top.compare_exchange_weak(top, next_top));
+    free_count++;
+    wakeFrameWaiters();
+}
+
+// Returns -1 if the pool is empty. The tag in free_top changes on every
+// push and pop, so a stale top cannot be swapped back in (ABA).
+int MemoryManager::popFreeFrame() {
+    uint64_t top = free_top.load();
+    uint64_t next_top;
+    int frame;
+    do {
+        frame = (int)(top & 0xFFFFFFFF) - 1;
+        if (frame < 0) return -1;
+        next_top = (((top >> 32) + 1) << 32) | (uint64_t)(free_next[frame].load() + 1);
+    } while (!free_top.compare_exchange_weak(top, next_top));
+    free_count--;
+    return frame;
+}
+
+bool MemoryManager::ShardInspector::isEvictable(int frame) {
+    const Frame& f = mmu.physical_memory[global(frame)];
+    return !f.is_free && !f.in_transit && std::find(busy.begin(), busy.end(), frame) == busy.end();
+}
+
+bool MemoryManager::ShardInspector::isReferenced(int frame, bool clear) {
+    const Frame& f = mmu.physical_memory[global(frame)];
+    if (!f.owner_table) return false;
+    bool referenced = f.owner_table->isReferenced(f.page_number);
+    if (clear && referenced) f.owner_table->setReferenced(f.page_number, false);
+    return referenced;
 }
 
-int MemoryManager::selectVictimFrame() {
+// Advisory: read without the owner's lock. Eviction re-checks under it.
+bool MemoryManager::ShardInspector::isDirty(int frame) {
+    const Frame& f = mmu.physical_memory[global(frame)];
+    return f.owner_table && f.owner_table->isDirty(f.page_number);
+}
 
-    if (fifo_queue.empty()) {
-        throw std::runtime_error("Attempted to select a victim frame, but FIFO queue is empty.");
+// Takes a resident frame from its owner for a new page, trying each shard's
+// policy in turn from first_shard. A victim whose page table is busy is put
+// back untouched and left out of that shard's later picks. Returns the frame
+// unmapped, marked in_transit and with the victim's page safely in the
+// backing store, or a frame that was freed while it waited.
+int MemoryManager::evictFrame(int first_shard) {
+    if (physical_memory.empty()) {
+        throw std::runtime_error("Attempted to select a victim frame, but there are no frames.");
     }
 
-    int victim_frame_index = fifo_queue.front();
-    
-    fifo_queue.pop_front();
+    // Each shard is aged or counted once per eviction, not once per pick.
+    std::vector<bool> started(shards.size(), false);
+    while (true) {
+        for (size_t n = 0; n < shards.size(); ++n) {
+            size_t shard_index = (first_shard + n) % shards.size();
+            Shard& shard = *shards[shard_index];
+            ShardInspector inspector(*this, shard_index);
+            std::unique_lock<std::mutex> shard_lock(shard.mutex);
+            if (!started[shard_index]) {
+                shard.policy->startEviction(inspector);
+                started[shard_index] = true;
+            }
+
+            while (true) {
+                int local = shard.policy->selectVictim(inspector);
+                if (local < 0) break;
+
+                int frame = local * (int)shards.size() + (int)shard_index;
+                Frame& victim = physical_memory[frame];
+                PageTable* victim_table = victim.owner_table;
+                std::unique_lock<std::mutex> table_lock(victim_table->getMutex(), std::try_to_lock);
+                if (!table_lock.owns_lock()) {
+                    // Its owner is mid-access; leave it resident.
+                    shard.policy->frameSkipped(local);
+                    inspector.busy.push_back(local);
+                    continue;
+                }
+
+                int victim_page_number = victim.page_number;
+                noteDropped(*victim_table, victim_page_number);
+                bool dirty = victim_table->isDirty(victim_page_number);
+                bool cleaned_ahead = victim.cleaned_ahead;
+                victim_table->unmapPage(victim_page_number);
+                unlinkResident(*victim_table, frame);
+                victim.owner_pid = -1;
+                victim.page_number = -1;
+                victim.owner_table = nullptr;
+                victim.in_transit = true;
+                shard_lock.unlock();
+
+                // Still holding the victim's table: if its owner faults the
+                // page straight back, it waits for this write to land.
+                if (dirty) {
+                    pages_paged_out++;
+                    writePageToBackingStore(*victim_table, victim_page_number, frame);
+                } else if (cleaned_ahead) {
+                    stalls_avoided++;
+                }
+                return frame;
+            }
+        }
 
-    return victim_frame_index;
+        // Every resident frame is in use right now; sleep until one is
+        // freed or filled. Table locks are released without a wake-up, so
+        // the wait is bounded.
+        std::unique_lock<std::mutex> wait_lock(frame_wait_mutex);
+        frame_waiters++;
+        int frame = popFreeFrame();
+        if (frame < 0) frame_wait_cv.wait_for(wait_lock, std::chrono::milliseconds(FRAME_WAIT_MS));
+        frame_waiters--;
+        if (frame < 0) frame = popFreeFrame();
+        if (frame >= 0) return frame;
+    }
+}
+
+void MemoryManager::wakeFrameWaiters() {
+    if (frame_waiters.load() == 0) return;
+    std::lock_guard<std::mutex> wait_lock(frame_wait_mutex);
+    frame_wait_cv.notify_all();
+}
+
+void MemoryManager::writebackDaemon() {
+    std::unique_lock<std::mutex> lock(writeback_mutex);
+    while (!writeback_stop) {
+        writeback_cv.wait_for(lock, std::chrono::milliseconds(50));
+        if (writeback_stop) break;
+        if (g_virtual_time) continue;
+        lock.unlock();
+        cleanAhead();
+        lock.lock();
+    }
 }
 
-void MemoryManager::loadPageFromBackingStore(int pid, int page_number, int frame_number) {
+// Writes out the dirty pages among each shard's next clean_target victims.
+// The pages stay mapped and are only marked clean. Their page tables are
+// held for the writes, which keeps the frames from being evicted or changed
+// mid-write; the shard lock is not. Returns the number of pages cleaned.
+size_t MemoryManager::cleanAhead() {
+    struct Job {
+        int frame;
+        int slot;
+    };
+    size_t cleaned = 0;
+
+    for (size_t shard_index = 0; shard_index < shards.size(); ++shard_index) {
+        Shard& shard = *shards[shard_index];
+        ShardInspector inspector(*this, shard_index);
+        std::vector<Job> jobs;
+        std::vector<std::unique_lock<std::mutex>> held_tables;
+
+        {
+            std::lock_guard<std::mutex> shard_lock(shard.mutex);
+            std::vector<int> upcoming;
+            shard.policy->peekVictims(clean_target, inspector, upcoming);
+            for (int local : upcoming) {
+                int frame_index = local * (int)shards.size() + (int)shard_index;
+                Frame& frame = physical_memory[frame_index];
+                PageTable* page_table = frame.owner_table;
 
-    std::fstream backing_store(backing_store_filename, std::ios::in | std::ios::binary);
+                bool held = false;
+                for (const auto& table_lock : held_tables) {
+                    if (table_lock.mutex() == &page_table->getMutex()) held = true;
+                }
+                if (!held) {
+                    std::unique_lock<std::mutex> table_lock(page_table->getMutex(), std::try_to_lock);
+                    if (!table_lock.owns_lock()) continue;
+                    held_tables.push_back(std::move(table_lock));
+                }
+                if (!page_table->isDirty(frame.page_number)) continue;
 
-    if (!backing_store.is_open()) {
-        std::cerr << "[MMU] CRITICAL ERROR: Could not open backing store for reading." << std::endl;
+                int slot = writableSlot(*page_table, frame.page_number);
+                page_table->setDirty(frame.page_number, false);
+                jobs.push_back({frame_index, slot});
+            }
+        }
+
+        writeback_queue += jobs.size();
+        for (const auto& job : jobs) {
+            const char* page_data = reinterpret_cast<const char*>(&physical_bytes[(size_t)job.frame * frame_size]);
+            backing_store.writeAt((long long)job.slot * frame_size, page_data, frame_size);
+            physical_memory[job.frame].cleaned_ahead = true;
+            writeback_queue--;
+        }
+        pages_cleaned += jobs.size();
+        pages_paged_out += jobs.size();
+        cleaned += jobs.size();
+    }
+    return cleaned;
+}
+
+// Slots are handed out lowest-first so the swap file stays as small as the
+// paged-out data allows.
+int MemoryManager::allocateSwapSlot() {
+    std::lock_guard<std::mutex> lock(swap_mutex);
+    for (size_t word = swap_search_start; word < swap_bitmap.size(); ++word) {
+        if (swap_bitmap[word] != ~0ULL) {
+            int bit = 0;
+            while (swap_bitmap[word] & (1ULL << bit)) bit++;
+            swap_bitmap[word] |= (1ULL << bit);
+            swap_search_start = word;
+            swap_slots_used++;
+            return (int)(word * 64 + bit);
+        }
+    }
+
+    // Every slot is taken; grow the file by another 64 slots.
+    swap_bitmap.push_back(1ULL);
+    swap_search_start = swap_bitmap.size() - 1;
+    swap_slots_used++;
+    return (int)(swap_search_start * 64);
+}
+
+// Takes count consecutive free slots, lowest-first, growing the file if no gap
+// is wide enough. Returns the first.
+int MemoryManager::allocateSwapRun(size_t count) {
+    std::lock_guard<std::mutex> lock(swap_mutex);
+    size_t first = 0;
+    size_t run = 0;
+    for (size_t slot = swap_search_start * 64; run < count; ++slot) {
+        if (slot / 64 >= swap_bitmap.size()) swap_bitmap.push_back(0);
+        if (swap_bitmap[slot / 64] & (1ULL << (slot % 64))) {
+            run = 0;
+            continue;
+        }
+        if (run++ == 0) first = slot;
+    }
+
+    for (size_t slot = first; slot < first + count; ++slot) {
+        swap_bitmap[slot / 64] |= (1ULL << (slot % 64));
+    }
+    swap_slots_used += count;
+    return (int)first;
+}
+
+void MemoryManager::freeSwapSlot(int slot) {
+    std::lock_guard<std::mutex> lock(swap_mutex);
+    auto shared = slot_sharers.find(slot);
+    if (shared != slot_sharers.end()) {
+        // Someone else still reads it.
+        if (--shared->second == 0) {
+            slot_sharers.erase(shared);
+            shared_slots--;
+        }
         return;
     }
 
-    long long offset = ((long long)(pid - 1) * max_process_memory) + ((long long)page_number * frame_size);
-    backing_store.seekg(offset);
-    std::vector<char> page_data(frame_size);
-    backing_store.read(page_data.data(), frame_size);
+    size_t word = (size_t)slot / 64;
+    swap_bitmap[word] &= ~(1ULL << (slot % 64));
+    swap_search_start = std::min(swap_search_start, word);
+    swap_slots_used--;
+}
+
+void MemoryManager::shareSwapSlot(int slot) {
+    std::lock_guard<std::mutex> lock(swap_mutex);
+    if (slot_sharers[slot]++ == 0) shared_slots++;
+}
 
-    backing_store.close();
+// Drops one reference to slot if it is shared. Returns false, doing nothing,
+// if the caller is its only user.
+bool MemoryManager::releaseSharedSlot(int slot) {
+    std::lock_guard<std::mutex> lock(swap_mutex);
+    auto shared = slot_sharers.find(slot);
+    if (shared == slot_sharers.end()) return false;
+    if (--shared->second == 0) {
+        slot_sharers.erase(shared);
+        shared_slots--;
+    }
+    return true;
+}
 
+// Caller holds page_table's lock. The slot to write page_number out to: its
+// own, or a new one if it has none or shares it.
+int MemoryManager::writableSlot(PageTable& page_table, int page_number) {
+    int slot = page_table.getSwapSlot(page_number);
+    if (slot >= 0 && releaseSharedSlot(slot)) {
+        cow_copies++;
+        slot = -1;
+    }
+    if (slot < 0) {
+        slot = allocateSwapSlot();
+        page_table.setSwapSlot(page_number, slot);
+    }
+    return slot;
 }
 
-void MemoryManager::writePageToBackingStore(int pid, int page_number) {
+// Reads pages first_page, first_page + 1, ... into frames, with one
+// backing-store read per run of consecutive slots. A page that was never
+// written out has no slot: it is all zeroes. Caller holds page_table's lock.
+// Returns how many pages came from the backing store.
+size_t MemoryManager::loadCluster(PageTable& page_table, int first_page, const std::vector<int>& frames) {
+    size_t read = 0;
+    size_t i = 0;
+    while (i < frames.size()) {
+        int slot = page_table.getSwapSlot(first_page + (int)i);
+        size_t run = 1;
+        while (slot >= 0 && i + run < frames.size() &&
+               page_table.getSwapSlot(first_page + (int)(i + run)) == slot + (int)run) {
+            run++;
+        }
 
-    std::fstream backing_store(backing_store_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::ate);
-    
-    if (!backing_store.is_open()) {
-        std::ofstream new_file(backing_store_filename, std::ios::binary);
-        new_file.close();
-        backing_store.open(backing_store_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::ate);
-        if(!backing_store.is_open()){
-            std::cerr << "[MMU] CRITICAL ERROR: Could not create or open backing store for writing." << std::endl;
-            return;
+        if (run == 1) {
+            char* page_data = reinterpret_cast<char*>(&physical_bytes[(size_t)frames[i] * frame_size]);
+            if (slot < 0 || !backing_store.readAt((long long)slot * frame_size, page_data, frame_size)) {
+                std::fill(page_data, page_data + frame_size, 0);
+            }
+        } else {
+            std::vector<char> buffer(run * frame_size);
+            if (!backing_store.readAt((long long)slot * frame_size, buffer.data(), buffer.size())) {
+                std::fill(buffer.begin(), buffer.end(), 0);
+            }
+            for (size_t k = 0; k < run; ++k) {
+                std::copy(buffer.begin() + k * frame_size, buffer.begin() + (k + 1) * frame_size,
+                          reinterpret_cast<char*>(&physical_bytes[(size_t)frames[i + k] * frame_size]));
+            }
         }
+        if (slot >= 0) read += run;
+        i += run;
     }
+    return read;
+}
 
+// The page keeps its slot after it is read back in, so a clean page can be
+// evicted again without a write; a dirty one overwrites its own slot unless
+// that is shared. Caller holds page_table's lock.
+void MemoryManager::writePageToBackingStore(PageTable& page_table, int page_number, int frame_number) {
+    int slot = writableSlot(page_table, page_number);
 
-    long long offset = ((long long)(pid - 1) * max_process_memory) + ((long long)page_number * frame_size);
-
+    const char* page_data = reinterpret_cast<const char*>(&physical_bytes[(size_t)frame_number * frame_size]);
+    backing_store.writeAt((long long)slot * frame_size, page_data, frame_size);
+}
 
-    std::vector<char> page_data(frame_size);
-    for(size_t i = 0; i < frame_size; ++i) {
-        page_data[i] = (i % 2 == 0) ? (char)pid : (char)page_number;
+// Caller holds page_table's lock. Returns how many pages after page_number
+// to bring in with it.
+size_t MemoryManager::planReadahead(PageTable& page_table, int page_number) {
+    PageTable::ReadaheadState& state = page_table.getReadaheadState();
+    if (page_number != state.next_page) {
+        state.window /= 2;
+        return 0;
     }
+    state.window = std::min(readahead_max, std::max<size_t>(1, state.window * 2));
+    return state.window;
+}
 
-    backing_store.seekp(offset);
-    backing_store.write(page_data.data(), frame_size);
-    backing_store.close();
-    
+// A free frame, or one taken from another page when there is none.
+int MemoryManager::takeFrame() {
+    int frame = popFreeFrame();
+    if (frame < 0) {
+        frame = evictFrame((int)(next_victim_shard++ % shards.size()));
+    }
+    return frame;
+}
 
+// Hands back a frame taken for a page that turned out not to need it.
+void MemoryManager::returnFrame(int frame) {
+    {
+        Shard& shard = *shards[shardOf(frame)];
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        physical_memory[frame].reset();
+        shard.policy->frameFreed(localIndex(frame));
+    }
+    journal->record(shardOf(frame), frame, 1, -1);
+    pushFreeFrame(frame);
 }
 
-void MemoryManager::handlePageFault(Process& faulting_process, int page_number) {
-    std::lock_guard<std::mutex> lock(mmu_mutex);
+// Faults on different processes only meet on the free-frame stack and, when
+// memory is full, on a shard lock while a victim is picked.
+void MemoryManager::handlePageFault(Process& faulting_process, int page_number, bool for_write) {
+    if (flat) {
+        throw std::logic_error("page fault in flat memory mode");
+    }
+    PageTable& page_table = *faulting_process.getPageTable();
+    page_table.checkPage(page_number);
+    page_faults++;
+    checkThrashing();
 
-    int target_frame_index = -1;
-    pages_paged_in++;
+    // The faulting page plus any read-ahead: the following pages that have a
+    // backing-store copy, up to the first resident one.
+    size_t cluster_size = 1;
+    {
+        std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+        noteReference(page_table, page_number);
+        if (page_table.getSwapSlot(page_number) >= 0) {
+            major_faults++;
+            size_t ahead = planReadahead(page_table, page_number);
+            while (cluster_size <= ahead && page_number + cluster_size < page_table.getNumPages()) {
+                int next = page_number + (int)cluster_size;
+                if (page_table.isPresent(next) || page_table.getSwapSlot(next) < 0) break;
+                cluster_size++;
+            }
+        } else {
+            minor_faults++;
+            if (!for_write) {
+                // Never written anywhere, so it reads as zeroes.
+                if (!page_table.isPresent(page_number)) {
+                    page_table.mapZeroPage(page_number);
+                    zero_page_maps++;
+                }
+                return;
+            }
+        }
+    }
+
+    // Read-ahead only fills free frames; evicting a page someone is using
+    // for one that might be used is a bad trade.
+    std::vector<int> frames{takeFrame()};
+    while (frames.size() < cluster_size) {
+        int frame = popFreeFrame();
+        if (frame < 0) break;
+        frames.push_back(frame);
+    }
 
+    {
+        std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+        // A prefetch may have mapped some of these in the meantime.
+        bool zero_page = page_table.isZeroPage(page_number);
+        size_t usable = 0;
+        if (!page_table.isPresent(page_number) || (for_write && zero_page)) {
+            usable = 1;
+            while (usable < frames.size() && !page_table.isPresent(page_number + (int)usable)) usable++;
+        }
+        for (size_t i = usable; i < frames.size(); ++i) {
+            returnFrame(frames[i]);
+        }
+        frames.resize(usable);
+        cluster_size = usable;
+
+        if (zero_page && cluster_size > 0) {
+            // First write to the shared zero page: it gets a zeroed frame.
+            noteAccess(page_table, page_number);
+            cow_copies++;
+        }
+        pages_paged_in += loadCluster(page_table, page_number, frames);
 
-    if (!free_frames.empty()) {
-        target_frame_index = free_frames.front();
-        free_frames.pop_front();
+        for (size_t i = 0; i < cluster_size; ++i) {
+            int page = page_number + (int)i;
+            installPage(page_table, faulting_process.getPid(), page, frames[i]);
+            if (i > 0) {
+                // Not used yet, so the policy should not think it was.
+                page_table.setReferenced(page, false);
+                page_table.setReadahead(page, true);
+            }
+        }
+        if (cluster_size > 0) page_table.getReadaheadState().next_page = page_number + (int)cluster_size;
+    }
+    if (cluster_size == 0) return;
+    readahead_pages += cluster_size - 1;
 
+    if (g_virtual_time) {
+        cleanAhead();
     } else {
-        target_frame_index = selectVictimFrame(); 
-
-        Frame& victim_frame = physical_memory[target_frame_index];
-        int victim_pid = victim_frame.owner_pid;
-        int victim_page_number = victim_frame.page_number;
-        
-        // Look up by PID: process names come from "screen -s <name>", so they
-        // cannot be reconstructed as "Process<pid>".
-        Process* victim_process = os_scheduler->findProcessByPid(victim_pid);
-
-        if (victim_process == nullptr) {
-            // Owner already finished and released this frame. Nothing reachable
-            // lives here, so reclaim it rather than crashing the emulator.
-            std::cerr << "[MMU] WARNING: victim frame " << target_frame_index
-                      << " owned by unknown PID " << victim_pid
-                      << "; reclaiming without write-back." << std::endl;
-            physical_memory[target_frame_index].reset();
+        writeback_cv.notify_one();
+    }
+}
+
+// Caller holds page_table's lock and owns frame.
+void MemoryManager::installPage(PageTable& page_table, int pid, int page_number, int frame) {
+    Shard& shard = *shards[shardOf(frame)];
+    std::lock_guard<std::mutex> shard_lock(shard.mutex);
+    page_table.mapPageToFrame(page_number, frame);
+    physical_memory[frame].assign(pid, page_number, &page_table);
+    journal->record(shardOf(frame), frame, 1, pid);
+    linkResident(page_table, frame);
+    shard.policy->frameLoaded(localIndex(frame));
+    wakeFrameWaiters();
+}
+
+// Caller holds page_table's lock. Credits the first use of a page brought in
+// speculatively.
+void MemoryManager::noteAccess(PageTable& page_table, int page_number) const {
+    if (page_table.isReadahead(page_number)) {
+        page_table.setReadahead(page_number, false);
+        readahead_hits++;
+    }
+    if (page_table.isPrefetched(page_number)) {
+        page_table.setPrefetched(page_number, false);
+        prefetch_used++;
+    }
+}
+
+// Caller holds page_table's lock. Charges a speculative page that is being
+// dropped without ever having been used.
+void MemoryManager::noteDropped(PageTable& page_table, int page_number) {
+    if (page_table.isReadahead(page_number)) {
+        page_table.setReadahead(page_number, false);
+        readahead_wasted++;
+    }
+    if (page_table.isPrefetched(page_number)) {
+        page_table.setPrefetched(page_number, false);
+        prefetch_wasted++;
+    }
+}
+
+// Caller holds page_table's lock. Adds page_number to the process's
+// working-set window, closing the window first if it has run its length.
+// Only pages holding a frame count: zero-page mappings cost no memory.
+// Page 0 holds the symbol table, which nearly every instruction touches
+// without asking the MMU, so each window starts with it if it has a frame.
+void MemoryManager::noteReference(PageTable& page_table, int page_number) const {
+    PageTable::WorkingSetState& ws = page_table.getWorkingSetState();
+    uint64_t now = g_cpu_tick;
+    if (!ws.started || now - ws.window_start >= WORKING_SET_WINDOW) {
+        if (ws.started) page_table.setWorkingSetSize(ws.touched.size());
+        for (int page : ws.touched) page_table.setInWindow(page, false);
+        ws.touched.clear();
+        if (page_table.getFrameNumber(0) >= 0) {
+            page_table.setInWindow(0, true);
+            ws.touched.push_back(0);
+        }
+        ws.started = true;
+        ws.window_start = now;
+    }
+
+    if (page_table.getFrameNumber(page_number) < 0 || page_table.isInWindow(page_number)) return;
+    page_table.setInWindow(page_number, true);
+    ws.touched.push_back(page_number);
+    if (ws.touched.size() > page_table.getWorkingSetSize()) page_table.setWorkingSetSize(ws.touched.size());
+}
+
+// Closes the thrashing window once it has run its length. Whoever gets
+// there first does it; everyone else carries on.
+void MemoryManager::checkThrashing() {
+    uint64_t now = g_cpu_tick;
+    if (now - thrash_window_start.load() < WORKING_SET_WINDOW) return;
+    std::unique_lock<std::mutex> lock(thrash_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || now - thrash_window_start.load() < WORKING_SET_WINDOW) return;
+
+    size_t accesses = page_hits + page_faults - window_accesses;
+    size_t majors = major_faults - window_major_faults;
+    if (accesses >= THRASH_MIN_ACCESSES) {
+        bool now_thrashing = majors * 100 >= accesses * THRASH_FAULT_PERCENT;
+        if (now_thrashing && !thrashing) thrash_episodes++;
+        thrashing = now_thrashing;
+    }
+    window_accesses += accesses;
+    window_major_faults += majors;
+    thrash_window_start = now;
+}
+
+bool MemoryManager::prefetchPage(Process& process, int page_number) {
+    if (flat) return false;
+    PageTable& page_table = *process.getPageTable();
+    if (!page_table.isValidPage(page_number)) return false;
+    {
+        std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+        if (page_table.isReleased() || page_table.isPresent(page_number)) return false;
+        if (page_table.getSwapSlot(page_number) < 0) {
+            // Nothing to read: the zero page will do until it is written.
+            page_table.mapZeroPage(page_number);
+            page_table.setReferenced(page_number, false);
+            page_table.setPrefetched(page_number, true);
+            zero_page_maps++;
+            prefetch_pages++;
+            return true;
+        }
+    }
+
+    int frame = popFreeFrame();
+    if (frame < 0) return false;
+
+    std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+    if (page_table.isReleased() || page_table.isPresent(page_number)) {
+        pushFreeFrame(frame);
+        return false;
+    }
+    pages_paged_in += loadCluster(page_table, page_number, {frame});
+    installPage(page_table, process.getPid(), page_number, frame);
+    page_table.setReferenced(page_number, false);
+    page_table.setPrefetched(page_number, true);
+    prefetch_pages++;
+    return true;
+}
+
+void MemoryManager::forkAddressSpace(Process& parent, Process& child) {
+    if (flat) return;
+    PageTable& from = *parent.getPageTable();
+    PageTable& to = *child.getPageTable();
+    std::lock_guard<std::mutex> table_lock(from.getMutex());
+    if (from.isReleased()) return;
+
+    // Pages in leaves the parent never allocated have nothing to share.
+    for (size_t i = from.nextPopulatedPage(0); i < from.getNumPages(); i = from.nextPopulatedPage(i + 1)) {
+        int page = (int)i;
+        if (from.isZeroPage(page)) {
+            to.mapZeroPage(page);
+            continue;
+        }
+
+        // A resident page's backing-store copy must be current to be shared.
+        int frame = from.getFrameNumber(page);
+        if (frame >= 0 && (from.isDirty(page) || from.getSwapSlot(page) < 0)) {
+            writePageToBackingStore(from, page, frame);
+            from.setDirty(page, false);
+            pages_paged_out++;
+        }
+
+        int slot = from.getSwapSlot(page);
+        if (slot >= 0) {
+            shareSwapSlot(slot);
+            to.setSwapSlot(page, slot);
+        }
+    }
+}
+
+bool MemoryManager::allocateFlat(Process& process) {
+    PageTable& page_table = *process.getPageTable();
+    auto started = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(flat_mutex);
+    // Only this function maps pages in flat mode, always under flat_mutex.
+    if (page_table.isReleased() || page_table.isPresent(0)) return true;
+
+    size_t pages = page_table.getNumPages();
+    size_t units = flat_allocator->blockSize(pages);
+    if (units > physical_memory.size()) {
+        throw std::length_error("process needs more memory than the system has");
+    }
+    bool retry = page_table.isFlatWaiting();
+    if (!retry) flat_requests++;
+
+    long long start = flat_allocator->allocate(pages);
+    if (start < 0 && compaction_threshold > 0 && flat_allocator->canCompact() && flat_free_units >= units) {
+        size_t free_units = flat_free_units;
+        size_t fragmented = 100 * (free_units - largestHole()) / free_units;
+        if (fragmented >= compaction_threshold) {
+            compactFlat();
+            start = flat_allocator->allocate(pages);
+        }
+    }
+    flat_alloc_ns += (size_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    if (start < 0) {
+        if (retry) {
+            flat_retries++;
         } else {
-            if (victim_process->getPageTable()->isDirty(victim_page_number)) {
-                pages_paged_out++;
-                writePageToBackingStore(victim_pid, victim_page_number);
+            flat_failures++;
+            page_table.setFlatWaiting(true);
+        }
+        return false;
+    }
+    page_table.setFlatWaiting(false);
+
+    {
+        std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+        // Fresh memory reads as zeroes, as it would from the zero page.
+        std::fill(physical_bytes.begin() + (size_t)start * frame_size,
+                  physical_bytes.begin() + ((size_t)start + pages) * frame_size, 0);
+        for (size_t i = 0; i < pages; ++i) {
+            page_table.mapPageToFrame((int)i, (int)start + (int)i);
+            physical_memory[start + i].assign(process.getPid(), (int)i, &page_table);
+        }
+    }
+    // Flat mode changes memory only under flat_mutex, so one bucket keeps
+    // its changes in order.
+    journal->record(0, (size_t)start, units, process.getPid());
+    flat_blocks[(size_t)start] = {&page_table, process.getPid(), units, pages};
+    flat_free_units -= units;
+    flat_slack_units += units - pages;
+    flat_allocations++;
+    return true;
+}
+
+// Caller holds flat_mutex. Slides every block down to close the holes
+// between them, moving each one's bytes and remapping its pages under its
+// page-table lock, so a running process never sees a half-moved block.
+void MemoryManager::compactFlat() {
+    std::map<size_t, FlatBlock> moved;
+    size_t next = 0;
+    for (const auto& entry : flat_blocks) {
+        size_t start = entry.first;
+        const FlatBlock& block = entry.second;
+        if (start != next) {
+            std::lock_guard<std::mutex> table_lock(block.page_table->getMutex());
+            // Always moving down, so a forward copy is safe.
+            std::copy(physical_bytes.begin() + start * frame_size,
+                      physical_bytes.begin() + (start + block.pages) * frame_size,
+                      physical_bytes.begin() + next * frame_size);
+            for (size_t i = 0; i < block.pages; ++i) physical_memory[start + i].reset();
+            for (size_t i = 0; i < block.pages; ++i) {
+                block.page_table->mapPageToFrame((int)i, (int)(next + i));
+                physical_memory[next + i].assign(block.pid, (int)i, block.page_table);
             }
+            journal->record(0, start, block.units, -1);
+            journal->record(0, next, block.units, block.pid);
+        }
+        moved[next] = block;
+        next += block.units;
+    }
+    flat_blocks.swap(moved);
+    flat_allocator->resetTo(next);
+    compactions++;
+}
+
+void MemoryManager::releaseFlat(PageTable& page_table) {
+    std::lock_guard<std::mutex> lock(flat_mutex);
+    std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+    page_table.setReleased(true);
+    int start = page_table.getFrameNumber(0);
+    if (start < 0) return;      // never got memory
+
+    auto it = flat_blocks.find((size_t)start);
+    const FlatBlock& block = it->second;
+    for (size_t i = 0; i < block.pages; ++i) {
+        page_table.unmapPage((int)i);
+        physical_memory[start + i].reset();
+    }
+    journal->record(0, (size_t)start, block.units, -1);
+    flat_allocator->release((size_t)start, block.units);
+    flat_free_units += block.units;
+    flat_slack_units -= block.units - block.pages;
+    flat_blocks.erase(it);
+}
+
+// Caller holds flat_mutex. In frames.
+size_t MemoryManager::largestHole() const {
+    std::vector<FlatAllocator::Hole> holes;
+    flat_allocator->getHoles(holes);
+    size_t largest = 0;
+    for (const auto& hole : holes) largest = std::max(largest, hole.size);
+    return largest;
+}
+
+// Old copies of the pages are given up (shared ones stay with their other
+// users) so the whole set can go to one fresh run of slots.
+size_t MemoryManager::swapOutProcess(Process& process) {
+    if (flat) return 0;
+    PageTable& page_table = *process.getPageTable();
+    std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+    if (page_table.isReleased() || page_table.getResidentCount() == 0) return 0;
+
+    // Zero-page mappings hold no frame and are left as they are.
+    std::vector<int> pages;
+    for (int frame = page_table.getResidentHead(); frame >= 0; frame = physical_memory[frame].next_resident) {
+        pages.push_back(physical_memory[frame].page_number);
+    }
+    std::sort(pages.begin(), pages.end());
+
+    for (int page : pages) {
+        int slot = page_table.getSwapSlot(page);
+        if (slot >= 0) {
+            freeSwapSlot(slot);
+            page_table.setSwapSlot(page, -1);
+        }
+    }
+
+    int first_slot = allocateSwapRun(pages.size());
+    std::vector<char> buffer(pages.size() * frame_size);
+    for (size_t i = 0; i < pages.size(); ++i) {
+        const uint8_t* page_data = &physical_bytes[(size_t)page_table.getFrameNumber(pages[i]) * frame_size];
+        std::copy(page_data, page_data + frame_size, buffer.begin() + i * frame_size);
+        page_table.setSwapSlot(pages[i], first_slot + (int)i);
+    }
+    backing_store.writeAt((long long)first_slot * frame_size, buffer.data(), buffer.size());
 
-            victim_process->getPageTable()->unmapPage(victim_page_number);
+    for (int page : pages) {
+        int frame = page_table.getFrameNumber(page);
+        {
+            Shard& shard = *shards[shardOf(frame)];
+            std::lock_guard<std::mutex> shard_lock(shard.mutex);
+            noteDropped(page_table, page);
+            unlinkResident(page_table, frame);
+            page_table.unmapPage(page);
+            page_table.setDirty(page, false);
+            physical_memory[frame].reset();
+            shard.policy->frameFreed(localIndex(frame));
         }
+        journal->record(shardOf(frame), frame, 1, -1);
+        pushFreeFrame(frame);
     }
 
-    loadPageFromBackingStore(faulting_process.getPid(), page_number, target_frame_index);
-    faulting_process.getPageTable()->mapPageToFrame(page_number, target_frame_index);
-    physical_memory[target_frame_index].assign(faulting_process.getPid(), page_number);
+    page_table.getSwappedPages() = pages;
+    process_swap_outs++;
+    pages_swapped_out += pages.size();
+    return pages.size();
+}
 
-    fifo_queue.push_back(target_frame_index);
-    
+bool MemoryManager::hasSwappedPages(Process& process) {
+    if (flat) return false;
+    PageTable& page_table = *process.getPageTable();
+    std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+    return !page_table.isReleased() && !page_table.getSwappedPages().empty();
 }
 
-void MemoryManager::releaseProcessMemory(int pid) {
-    std::lock_guard<std::mutex> lock(mmu_mutex);
-    for (size_t i = 0; i < physical_memory.size(); ++i) {
-        if (physical_memory[i].owner_pid == pid) {
+size_t MemoryManager::swapInProcess(Process& process) {
+    if (flat) return 0;
+    PageTable& page_table = *process.getPageTable();
+    std::lock_guard<std::mutex> table_lock(page_table.getMutex());
+    std::vector<int> pages;
+    pages.swap(page_table.getSwappedPages());
+    if (page_table.isReleased() || pages.empty()) return 0;
 
-            physical_memory[i].reset();
-            free_frames.push_back(i);
-            fifo_queue.erase(std::remove(fifo_queue.begin(), fifo_queue.end(), i), fifo_queue.end());
+    // Some may have been prefetched back already.
+    std::vector<int> loading, frames;
+    for (int page : pages) {
+        if (page_table.isPresent(page) || page_table.getSwapSlot(page) < 0) continue;
+        int frame = popFreeFrame();
+        if (frame < 0) break;
+        loading.push_back(page);
+        frames.push_back(frame);
+    }
+
+    size_t i = 0;
+    while (i < loading.size()) {
+        int slot = page_table.getSwapSlot(loading[i]);
+        size_t run = 1;
+        while (i + run < loading.size() && page_table.getSwapSlot(loading[i + run]) == slot + (int)run) {
+            run++;
+        }
+
+        std::vector<char> buffer(run * frame_size);
+        if (!backing_store.readAt((long long)slot * frame_size, buffer.data(), buffer.size())) {
+            std::fill(buffer.begin(), buffer.end(), 0);
+        }
+        for (size_t k = 0; k < run; ++k) {
+            std::copy(buffer.begin() + k * frame_size, buffer.begin() + (k + 1) * frame_size,
+                      reinterpret_cast<char*>(&physical_bytes[(size_t)frames[i + k] * frame_size]));
+            installPage(page_table, process.getPid(), loading[i + k], frames[i + k]);
         }
+        i += run;
     }
+
+    process_swap_ins++;
+    pages_swapped_in += loading.size();
+    return loading.size();
+}
+
+void MemoryManager::releaseProcessMemory(Process& process) {
+    if (flat) {
+        releaseFlat(*process.getPageTable());
+        return;
+    }
+    PageTable* page_table = process.getPageTable();
+    // Also waits out any eviction or writeback holding this table.
+    std::lock_guard<std::mutex> table_lock(page_table->getMutex());
+    page_table->setReleased(true);
+    page_table->getSwappedPages().clear();
+
+    for (size_t page = page_table->nextPopulatedPage(0);
+         page < page_table->getNumPages() && page_table->getSwapSlotCount() > 0;
+         page = page_table->nextPopulatedPage(page + 1)) {
+        int slot = page_table->getSwapSlot((int)page);
+        if (slot >= 0) {
+            freeSwapSlot(slot);
+            page_table->setSwapSlot((int)page, -1);
+        }
+    }
+
+    // Only the frames this process owns are touched.
+    int frame = page_table->getResidentHead();
+    while (frame >= 0) {
+        int next = physical_memory[frame].next_resident;
+        {
+            Shard& shard = *shards[shardOf(frame)];
+            std::lock_guard<std::mutex> shard_lock(shard.mutex);
+            noteDropped(*page_table, physical_memory[frame].page_number);
+            page_table->unmapPage(physical_memory[frame].page_number);
+            physical_memory[frame].reset();
+            shard.policy->frameFreed(localIndex(frame));
+        }
+        journal->record(shardOf(frame), frame, 1, -1);
+        pushFreeFrame(frame);
+        frame = next;
+    }
+    page_table->setResidentHead(-1);
+    page_table->setResidentCount(0);
+}
+
+// Caller holds page_table's lock and the frame's shard lock. Pushes frame
+// onto the front of the owner's list.
+void MemoryManager::linkResident(PageTable& page_table, int frame) {
+    int head = page_table.getResidentHead();
+    physical_memory[frame].prev_resident = -1;
+    physical_memory[frame].next_resident = head;
+    if (head >= 0) physical_memory[head].prev_resident = frame;
+    page_table.setResidentHead(frame);
+    page_table.setResidentCount(page_table.getResidentCount() + 1);
+}
+
+// Caller holds page_table's lock and the frame's shard lock.
+void MemoryManager::unlinkResident(PageTable& page_table, int frame) {
+    Frame& f = physical_memory[frame];
+    if (f.prev_resident >= 0) {
+        physical_memory[f.prev_resident].next_resident = f.next_resident;
+    } else {
+        page_table.setResidentHead(f.next_resident);
+    }
+    if (f.next_resident >= 0) physical_memory[f.next_resident].prev_resident = f.prev_resident;
+    f.prev_resident = f.next_resident = -1;
+    page_table.setResidentCount(page_table.getResidentCount() - 1);
+}
+
+bool MemoryManager::readWord(Process& process, uint32_t address, uint16_t& value) const {
+    std::lock_guard<std::mutex> lock(process.getPageTable()->getMutex());
+    address &= ~1u;
+    int page = (int)(address / frame_size);
+    process.getPageTable()->checkPage(page);
+    if (!process.getPageTable()->isPresent(page)) return false;
+    process.getPageTable()->setReferenced(page, true);
+    noteAccess(*process.getPageTable(), page);
+    noteReference(*process.getPageTable(), page);
+    if (process.getPageTable()->isZeroPage(page)) {
+        value = 0;
+        return true;
+    }
+    int frame = process.getPageTable()->getFrameNumber(page);
+
+    size_t offset = (size_t)frame * frame_size + address % frame_size;
+    value = (uint16_t)(physical_bytes[offset] | (physical_bytes[offset + 1] << 8));
+    return true;
+}
+
+bool MemoryManager::writeWord(Process& process, uint32_t address, uint16_t value) {
+    std::lock_guard<std::mutex> lock(process.getPageTable()->getMutex());
+    address &= ~1u;
+    int page = (int)(address / frame_size);
+    process.getPageTable()->checkPage(page);
+    int frame = process.getPageTable()->getFrameNumber(page);
+    if (frame < 0) return false;
+
+    size_t offset = (size_t)frame * frame_size + address % frame_size;
+    physical_bytes[offset] = (uint8_t)(value & 0xFF);
+    physical_bytes[offset + 1] = (uint8_t)(value >> 8);
+    process.getPageTable()->setDirty(page, true);
+    process.getPageTable()->setReferenced(page, true);
+    noteAccess(*process.getPageTable(), page);
+    noteReference(*process.getPageTable(), page);
+    return true;
+}
+
+void MemoryManager::sealSnapshot(uint64_t quantum, uint64_t tick) {
+    journal->seal(quantum, tick, g_virtual_time ? 0 : (int64_t)std::time(nullptr));
+}
+
+bool MemoryManager::renderMemoryStamp(uint64_t quantum) {
+    return journal->renderStamp(quantum);
+}
+
+size_t MemoryManager::renderAllMemoryStamps() {
+    return journal->renderAllStamps();
+}
+
+uint64_t MemoryManager::getLastSnapshotQuantum() const {
+    return journal->getLastQuantum();
 }
 
 size_t MemoryManager::getPageSize() const {
@@ -161,9 +1034,8 @@ size_t MemoryManager::getTotalMemory() const {
 
 
 size_t MemoryManager::getFreeMemory() const {
-
-    std::lock_guard<std::mutex> lock(mmu_mutex);
-    return free_frames.size() * frame_size;
+    if (flat) return flat_free_units.load() * frame_size;
+    return free_count.load() * frame_size;
 }
 
 
@@ -178,4 +1050,159 @@ size_t MemoryManager::getNumPagedIn() const {
 
 size_t MemoryManager::getNumPagedOut() const {
     return pages_paged_out.load(); // Use .load() for safe atomic reads
-}
\ No newline at end of file
+}
+
+size_t MemoryManager::getNumReadaheadPages() const {
+    return readahead_pages.load();
+}
+
+size_t MemoryManager::getNumReadaheadHits() const {
+    return readahead_hits.load();
+}
+
+size_t MemoryManager::getNumReadaheadWasted() const {
+    return readahead_wasted.load();
+}
+
+size_t MemoryManager::getNumPrefetchPages() const {
+    return prefetch_pages.load();
+}
+
+size_t MemoryManager::getNumPrefetchUsed() const {
+    return prefetch_used.load();
+}
+
+size_t MemoryManager::getNumPrefetchWasted() const {
+    return prefetch_wasted.load();
+}
+
+size_t MemoryManager::getSwapUsed() const {
+    return swap_slots_used.load() * frame_size;
+}
+
+size_t MemoryManager::getWritebackQueueDepth() const {
+    return writeback_queue.load();
+}
+
+std::string MemoryManager::getReplacementPolicyName() const {
+    return replacement_name;
+}
+
+size_t MemoryManager::getNumPageHits() const {
+    return page_hits.load();
+}
+
+size_t MemoryManager::getNumPageFaults() const {
+    return page_faults.load();
+}
+
+size_t MemoryManager::getNumMinorFaults() const {
+    return minor_faults.load();
+}
+
+size_t MemoryManager::getNumMajorFaults() const {
+    return major_faults.load();
+}
+
+size_t MemoryManager::getNumZeroPageMaps() const {
+    return zero_page_maps.load();
+}
+
+size_t MemoryManager::getNumCowCopies() const {
+    return cow_copies.load();
+}
+
+size_t MemoryManager::getNumSharedSlots() const {
+    return shared_slots.load();
+}
+
+void MemoryManager::recordPageHits(size_t hits) {
+    if (hits == 0) return;
+    page_hits += hits;
+    checkThrashing();
+}
+
+bool MemoryManager::isFlat() const {
+    return flat;
+}
+
+std::string MemoryManager::getMemoryModeName() const {
+    return flat ? "flat (" + flat_allocator->getName() + ")" : "paging";
+}
+
+size_t MemoryManager::getNumFlatAllocations() const {
+    return flat_allocations.load();
+}
+
+size_t MemoryManager::getNumFlatFailures() const {
+    return flat_failures.load();
+}
+
+size_t MemoryManager::getNumFlatRetries() const {
+    return flat_retries.load();
+}
+
+size_t MemoryManager::getNumCompactions() const {
+    return compactions.load();
+}
+
+// Per request, counting the time of every try it took.
+double MemoryManager::getAvgFlatAllocMicros() const {
+    size_t requests = flat_requests.load();
+    return requests > 0 ? flat_alloc_ns.load() / 1000.0 / requests : 0.0;
+}
+
+size_t MemoryManager::getExternalFragmentation() const {
+    return flat ? getFreeMemory() : 0;
+}
+
+size_t MemoryManager::getLargestHole() const {
+    if (!flat) return 0;
+    std::lock_guard<std::mutex> lock(flat_mutex);
+    return largestHole() * frame_size;
+}
+
+size_t MemoryManager::getInternalFragmentation() const {
+    return flat_slack_units.load() * frame_size;
+}
+
+size_t MemoryManager::getNumProcessesInMemory() const {
+    std::lock_guard<std::mutex> lock(flat_mutex);
+    return flat_blocks.size();
+}
+
+size_t MemoryManager::getNumProcessSwapOuts() const {
+    return process_swap_outs.load();
+}
+
+size_t MemoryManager::getNumProcessSwapIns() const {
+    return process_swap_ins.load();
+}
+
+size_t MemoryManager::getNumPagesSwappedOut() const {
+    return pages_swapped_out.load();
+}
+
+size_t MemoryManager::getNumPagesSwappedIn() const {
+    return pages_swapped_in.load();
+}
+
+size_t MemoryManager::getWorkingSet(Process& process) const {
+    return process.getPageTable()->getWorkingSetSize();
+}
+
+bool MemoryManager::isThrashing() const {
+    return thrashing.load();
+}
+
+size_t MemoryManager::getNumThrashEpisodes() const {
+    return thrash_episodes.load();
+}
+
+size_t MemoryManager::getNumPagesCleaned() const {
+    return pages_cleaned.load();
+}
+
+size_t MemoryManager::getNumStallsAvoided() const {
+    return stalls_avoided.load();
+}
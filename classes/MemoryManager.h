@@ -2,40 +2,324 @@
 #pragma once
 
 #include <vector>
-#include <deque>
 #include <mutex>
+#include <string>
+#include <cstdint>
+#include <memory>
 #include "Frame.h"
+#include "BackingStore.h"
+#include "ReplacementPolicy.h"
+#include "FlatAllocator.h"
+#include "MemoryJournal.h"
 #include <atomic>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <condition_variable>
 
-class Process; 
+class Process;
+class PageTable;
 
+// Locking: there is no global MMU lock.
+//  - Each PageTable's mutex guards that process's entries and the bytes of
+//    the frames it has mapped.
+//  - Frames are split into shards (frame % shard count). A shard's mutex
+//    guards its replacement policy state.
+//  - A frame's mapping (owner, page, resident links) only changes with both
+//    its shard lock and its owner's page-table lock held, so either one is
+//    enough to read it.
+//  - Blocking order is page table -> shard. Code holding a shard lock only
+//    ever try_locks a page table, and skips the frame if that fails.
+//  - The free-frame pool is a lock-free stack; swap slots have swap_mutex.
 class MemoryManager {
 private:
+    static constexpr size_t MAX_SHARDS = 8;
+    static constexpr size_t MIN_SHARD_FRAMES = 16;  // smaller shards evict badly
+
+    struct Shard {
+        std::mutex mutex;
+        std::unique_ptr<ReplacementPolicy> policy;
+    };
+
+    // Shows a shard's policy its frames by shard-local index.
+    class ShardInspector : public FrameInspector {
+    private:
+        MemoryManager& mmu;
+        size_t shard;
+        int global(int frame) const { return (int)(frame * mmu.shards.size() + shard); }
+    public:
+        // Frames found with their table locked during this eviction.
+        std::vector<int> busy;
+        ShardInspector(MemoryManager& mmu, size_t shard) : mmu(mmu), shard(shard) {}
+        bool isEvictable(int frame) override;
+        bool isReferenced(int frame, bool clear) override;
+        bool isDirty(int frame) override;
+    };
+
     std::vector<Frame> physical_memory;
-    std::deque<int> free_frames; 
-    std::deque<int> fifo_queue;         
+    std::vector<uint8_t> physical_bytes;    // frame i holds bytes [i*frame_size, (i+1)*frame_size)
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::string replacement_name;
+    std::atomic<size_t> next_victim_shard{0};   // evictions rotate over the shards
     size_t frame_size;
-    size_t max_process_memory; 
+
+    // Treiber stack of free frames. free_top packs an ABA tag in the high 32
+    // bits and (frame + 1) in the low 32, 0 meaning empty.
+    std::atomic<uint64_t> free_top{0};
+    std::unique_ptr<std::atomic<int>[]> free_next;
+    std::atomic<size_t> free_count{0};
+    // An eviction that found every resident frame busy waits here until a
+    // frame is freed or filled, or for at most FRAME_WAIT_MS.
+    static constexpr int FRAME_WAIT_MS = 1;
+    std::mutex frame_wait_mutex;
+    std::condition_variable frame_wait_cv;
+    std::atomic<int> frame_waiters{0};
+    void wakeFrameWaiters();
+
     const std::string backing_store_filename = "csopesy-backing-store.txt";
-    mutable std::mutex mmu_mutex; 
-    std::atomic<size_t> pages_paged_in{0};
+    const std::string journal_filename = "csopesy-memory-journal.bin";
+    BackingStore backing_store;     // opened once, truncated at startup
+    // One bit per frame-sized slot of the backing store, set while a page's
+    // copy lives there. The file only grows when every slot is taken.
+    std::mutex swap_mutex;
+    std::vector<uint64_t> swap_bitmap;
+    size_t swap_search_start = 0;   // word to start looking for a free slot
+    std::atomic<size_t> swap_slots_used{0};
+    // Forked processes share their parent's slots copy-on-write: a slot
+    // listed here has that many references besides its first. Writing a
+    // page out never touches a shared slot; the writer gets its own.
+    std::unordered_map<int, int> slot_sharers;
+    std::atomic<size_t> shared_slots{0};
+
+    // Medium-term swapping: whole processes written out and read back in
+    // one batch each. Counted apart from demand paging.
+    std::atomic<size_t> process_swap_outs{0};
+    std::atomic<size_t> process_swap_ins{0};
+    std::atomic<size_t> pages_swapped_out{0};
+    std::atomic<size_t> pages_swapped_in{0};
+
+    std::atomic<size_t> pages_paged_in{0};     // read from the backing store; zero fills are not
     std::atomic<size_t> pages_paged_out{0};
-    
-    int selectVictimFrame();
-    void loadPageFromBackingStore(int pid, int page_number, int frame_number);
-    void writePageToBackingStore(int pid, int page_number);
+    std::atomic<size_t> page_hits{0};
+    std::atomic<size_t> page_faults{0};
+    // A fault on a page that was never written out has nothing to read: it
+    // gets a zeroed frame (minor). Only pages with a swap slot cost a
+    // backing-store read (major).
+    std::atomic<size_t> minor_faults{0};
+    std::atomic<size_t> major_faults{0};
+    // Read faults on never-written pages map the shared zero page instead
+    // of a frame; the first write gives the page a frame of its own.
+    std::atomic<size_t> zero_page_maps{0};
+    std::atomic<size_t> cow_copies{0};         // zero-page or shared-slot copies made on write
+
+    // Read-ahead: a fault on the page right after a process's last cluster
+    // doubles its window, up to readahead_max pages; any other fault halves
+    // it. Speculative pages only go into free frames and are mapped with
+    // their readahead bit set.
+    static constexpr size_t READAHEAD_MAX = 8;
+    size_t readahead_max;
+    std::atomic<size_t> readahead_pages{0};             // brought in ahead of use
+    mutable std::atomic<size_t> readahead_hits{0};      // ...and accessed later
+    std::atomic<size_t> readahead_wasted{0};            // ...and dropped untouched
+
+    // Pages the scheduler asked for ahead of a process's READ/WRITEs.
+    std::atomic<size_t> prefetch_pages{0};
+    mutable std::atomic<size_t> prefetch_used{0};
+    std::atomic<size_t> prefetch_wasted{0};
+
+    // Thrashing: a WORKING_SET_WINDOW in which at least THRASH_FAULT_PERCENT
+    // of accesses were major faults, waiting on a backing-store read; zero
+    // fills are cheap and prove nothing. Consecutive such windows are one
+    // episode.
+    static const size_t THRASH_FAULT_PERCENT = 10;
+    static const size_t THRASH_MIN_ACCESSES = 32;  // quieter windows prove nothing
+    std::mutex thrash_mutex;
+    std::atomic<uint64_t> thrash_window_start{0};
+    size_t window_accesses = 0;     // page_hits + page_faults when the window opened
+    size_t window_major_faults = 0;
+    std::atomic<bool> thrashing{false};
+    std::atomic<size_t> thrash_episodes{0};
+
+    // memory-mode flat: each process gets one contiguous block of frames,
+    // mapped whole before it first runs and kept until it finishes; nothing
+    // is paged. flat_mutex guards the allocator and flat_blocks and is taken
+    // before any page-table lock.
+    struct FlatBlock {
+        PageTable* page_table;
+        int pid;
+        size_t units;       // frames taken, which buddy may round up
+        size_t pages;       // frames the process uses
+    };
+    bool flat = false;
+    std::unique_ptr<FlatAllocator> flat_allocator;
+    std::map<size_t, FlatBlock> flat_blocks;    // by first frame
+    mutable std::mutex flat_mutex;
+    size_t compaction_threshold = 0;    // fragmentation percent that triggers it; 0 never
+    std::atomic<size_t> flat_free_units{0};
+    std::atomic<size_t> flat_slack_units{0};    // taken but unused (internal fragmentation)
+    // A request is one process asking for its block, however many tries it
+    // takes: a failure is a request that had to wait, a retry each later
+    // try that failed too.
+    std::atomic<size_t> flat_requests{0};
+    std::atomic<size_t> flat_allocations{0};
+    std::atomic<size_t> flat_failures{0};
+    std::atomic<size_t> flat_retries{0};
+    std::atomic<size_t> flat_alloc_ns{0};       // time spent in allocateFlat, compaction included
+    std::atomic<size_t> compactions{0};
+
+    size_t largestHole() const;
+    void compactFlat();
+    void releaseFlat(PageTable& page_table);
+
+    // Every change of frame ownership, for memory stamps. Constructed last
+    // so it knows the frame count.
+    std::unique_ptr<MemoryJournal> journal;
+
+    // Writeback daemon: keeps the next clean_target victims of each shard
+    // clean so a fault can usually evict without writing. In turbo mode the
+    // same pass runs inline on the fault path instead, to keep runs
+    // deterministic.
+    size_t clean_target;
+    std::thread writeback_thread;
+    std::mutex writeback_mutex;
+    std::condition_variable writeback_cv;       // wakes the daemon
+    bool writeback_stop = false;
+    std::atomic<size_t> writeback_queue{0};     // pages picked but not yet written
+    std::atomic<size_t> pages_cleaned{0};
+    std::atomic<size_t> stalls_avoided{0};
+
+    void writebackDaemon();
+    size_t cleanAhead();
+
+    void pushFreeFrame(int frame);
+    int popFreeFrame();
+    size_t shardOf(int frame) const { return (size_t)frame % shards.size(); }
+    int localIndex(int frame) const { return (int)((size_t)frame / shards.size()); }
+
+    int evictFrame(int first_shard);
+    int takeFrame();
+    size_t planReadahead(PageTable& page_table, int page_number);
+    void installPage(PageTable& page_table, int pid, int page_number, int frame);
+    void noteAccess(PageTable& page_table, int page_number) const;
+    void noteDropped(PageTable& page_table, int page_number);
+    void noteReference(PageTable& page_table, int page_number) const;
+    void checkThrashing();
+    void linkResident(PageTable& page_table, int frame);
+    void unlinkResident(PageTable& page_table, int frame);
+    size_t loadCluster(PageTable& page_table, int first_page, const std::vector<int>& frames);
+    void writePageToBackingStore(PageTable& page_table, int page_number, int frame_number);
+    int allocateSwapSlot();
+    int allocateSwapRun(size_t count);
+    void freeSwapSlot(int slot);
+    void shareSwapSlot(int slot);
+    bool releaseSharedSlot(int slot);
+    int writableSlot(PageTable& page_table, int page_number);
+    void returnFrame(int frame);
 
 public:
-    MemoryManager(size_t total_memory_size, size_t frame_size, size_t mem_per_proc);
+    // Length, in ticks, of the window working sets and thrashing are
+    // measured over.
+    static const uint64_t WORKING_SET_WINDOW = 100;
+
+    // Throws std::invalid_argument for an unknown replacement policy, memory
+    // mode ("paging" or "flat") or flat allocator.
+    MemoryManager(size_t total_memory_size, size_t frame_size, const std::string& replacement_policy = "fifo",
+                  const std::string& memory_mode = "paging", const std::string& flat_allocator_name = "first-fit",
+                  size_t compaction_threshold = 0);
+    ~MemoryManager();
+
+
+    // Paging mode only; throws std::logic_error in flat mode, and
+    // std::out_of_range for a page the process does not have.
+    void handlePageFault(Process& process, int page_number, bool for_write = false);
+    // Flat mode: gives process one contiguous block for all its pages unless
+    // it already has one. Compacts first if that is enabled and would make
+    // room. Returns false if memory is too full or fragmented; throws
+    // std::length_error if the process is bigger than memory.
+    bool allocateFlat(Process& process);
+    void releaseProcessMemory(Process& process);
+    // Brings page_number in ahead of use if it is not resident and a frame
+    // is free. Never evicts. Returns whether the page was loaded; false for
+    // a page the process does not have.
+    bool prefetchPage(Process& process, int page_number);
+    // Gives child, a fresh fork of parent, the same memory contents without
+    // copying them: its pages share parent's backing-store copies and the
+    // zero page until one side writes.
+    void forkAddressSpace(Process& parent, Process& child);
+    // Medium-term swapper. swapOutProcess writes every resident page of a
+    // process that is on no core to consecutive swap slots in a single
+    // write and frees its frames; swapInProcess reads them back into free
+    // frames, one read per run of slots, leaving any that do not fit to
+    // fault in. Both return the number of pages moved.
+    size_t swapOutProcess(Process& process);
+    size_t swapInProcess(Process& process);
+    // Whether swapInProcess has anything to read back for process.
+    bool hasSwappedPages(Process& process);
+
+    // Word access to a process's memory, translated through its page table.
+    // Addresses are rounded down to a 2-byte boundary. Both return false,
+    // touching nothing, if the page is not resident; the caller should fault
+    // it in and retry. They throw std::out_of_range past the process's pages.
+    bool readWord(Process& process, uint32_t address, uint16_t& value) const;
+    bool writeWord(Process& process, uint32_t address, uint16_t value);
 
+    // Ends a quantum cycle, at the given tick, for the memory journal.
+    // Never waits on I/O.
+    void sealSnapshot(uint64_t quantum, uint64_t tick);
+    // Writes memory_stamp_<qq>.txt for one quantum, or for every quantum
+    // with a change. Return whether / how many stamps were written.
+    bool renderMemoryStamp(uint64_t quantum);
+    size_t renderAllMemoryStamps();
+    uint64_t getLastSnapshotQuantum() const;
 
-    void handlePageFault(Process& process, int page_number);
-    void releaseProcessMemory(int pid);
+    // Statistics; none of these take a lock.
     size_t getPageSize() const;
     size_t getTotalMemory() const;
     size_t getFreeMemory() const;
     size_t getUsedMemory() const;
     size_t getNumPagedIn() const;
     size_t getNumPagedOut() const;
+    size_t getNumReadaheadPages() const;
+    size_t getNumReadaheadHits() const;
+    size_t getNumReadaheadWasted() const;
+    size_t getNumPrefetchPages() const;
+    size_t getNumPrefetchUsed() const;
+    size_t getNumPrefetchWasted() const;
+    size_t getSwapUsed() const;     // bytes of the backing store holding live pages
+    size_t getWritebackQueueDepth() const;
+    std::string getReplacementPolicyName() const;
+    size_t getNumPageHits() const;
+    size_t getNumPageFaults() const;
+    size_t getNumMinorFaults() const;
+    size_t getNumMajorFaults() const;
+    size_t getNumZeroPageMaps() const;
+    size_t getNumCowCopies() const;
+    size_t getNumSharedSlots() const;
+    bool isFlat() const;
+    std::string getMemoryModeName() const;     // "paging", or "flat (<allocator>)"
+    size_t getNumFlatAllocations() const;
+    size_t getNumFlatFailures() const;
+    size_t getNumFlatRetries() const;
+    size_t getNumCompactions() const;
+    double getAvgFlatAllocMicros() const;
+    size_t getExternalFragmentation() const;    // free bytes, all holes together
+    size_t getInternalFragmentation() const;    // bytes allocated but unused
+    // These two take flat_mutex.
+    size_t getLargestHole() const;              // bytes
+    size_t getNumProcessesInMemory() const;     // flat mode
+    size_t getNumProcessSwapOuts() const;
+    size_t getNumProcessSwapIns() const;
+    size_t getNumPagesSwappedOut() const;
+    size_t getNumPagesSwappedIn() const;
+    // Distinct pages holding a frame that process touched in its last
+    // working-set window (or the current one, if more); 0 before any.
+    size_t getWorkingSet(Process& process) const;
+    bool isThrashing() const;
+    size_t getNumThrashEpisodes() const;
+    // Accesses that found their page resident, reported in bulk by the
+    // scheduler once per slice.
+    void recordPageHits(size_t hits);
+    size_t getNumPagesCleaned() const;
+    size_t getNumStallsAvoided() const;
 
-};
\ No newline at end of file
+};
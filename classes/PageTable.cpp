@@ -1,75 +1,282 @@
 
 // PageTable.cpp
 #include "PageTable.h"
+#include <algorithm>
 #include <stdexcept> 
 
-PageTable::PageTable(size_t process_memory_size, size_t page_size) {
+PageTable::PageTable(size_t process_memory_size, size_t page_size, int levels) {
 
     this->page_size = page_size;
 
     if (page_size == 0) {
         throw std::invalid_argument("Page size cannot be zero.");
     }
+    if (levels != 1 && levels != 2) {
+        throw std::invalid_argument("A page table has one or two levels.");
+    }
 
     this->num_pages = (process_memory_size + page_size - 1) / page_size;
+    this->levels = levels;
+
+    leaf_shift = 0;
+    if (levels == 2) {
+        leaf_shift = LEAF_SHIFT;
+    } else {
+        while (((size_t)1 << leaf_shift) < this->num_pages) leaf_shift++;
+    }
+    leaf_mask = ((size_t)1 << leaf_shift) - 1;
+    num_leaves = (this->num_pages + leaf_mask) >> leaf_shift;
+    directory.reset(new std::atomic<Leaf*>[num_leaves]());
+    table_bytes = num_leaves * sizeof(std::atomic<Leaf*>);
 
-    entries.resize(this->num_pages);
+    if (levels == 1 && num_leaves > 0) leafFor(0);
 }
 
-int PageTable::getFrameNumber(int page_number) const {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
+PageTable::~PageTable() {
+    for (size_t i = 0; i < num_leaves; ++i) {
+        delete directory[i].load();
     }
+}
 
-    // check if present in memory
-    if (entries[page_number].present_bit) {
-        return entries[page_number].frame_number;
+bool PageTable::isValidPage(int page_number) const {
+    return page_number >= 0 && (size_t)page_number < this->num_pages;
+}
+
+void PageTable::checkPage(int page_number) const {
+    if (!isValidPage(page_number)) {
+        throw std::out_of_range("Page number is out of the valid range for this process.");
     }
+}
 
-    return -1;
+std::atomic<PageTable::PageTableEntry>* PageTable::findEntry(int page_number) const {
+    Leaf* leaf = directory[(size_t)page_number >> leaf_shift].load(std::memory_order_acquire);
+    return leaf ? &leaf->entries[(size_t)page_number & leaf_mask] : nullptr;
 }
 
-bool PageTable::isPresent(int page_number) const {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
+// Two threads may race to allocate the same leaf; the loser frees its copy.
+PageTable::Leaf& PageTable::leafFor(int page_number) {
+    size_t index = (size_t)page_number >> leaf_shift;
+    Leaf* leaf = directory[index].load(std::memory_order_acquire);
+    if (leaf) return *leaf;
+
+    Leaf* fresh = new Leaf;
+    fresh->size = std::min(leaf_mask + 1, this->num_pages - (index << leaf_shift));
+    fresh->entries.reset(new std::atomic<PageTableEntry>[fresh->size]());
+    if (!directory[index].compare_exchange_strong(leaf, fresh, std::memory_order_acq_rel)) {
+        delete fresh;
+        return *leaf;
     }
+    table_bytes += fresh->size * sizeof(PageTableEntry);
+    return *fresh;
+}
 
-    return entries[page_number].present_bit;
+// Clearing a flag never needs a leaf: an absent page has none set.
+void PageTable::setFlag(int page_number, PageTableEntry flag, bool on) {
+    if (on) {
+        leafFor(page_number).entries[(size_t)page_number & leaf_mask].fetch_or(flag, std::memory_order_relaxed);
+    } else if (std::atomic<PageTableEntry>* entry = findEntry(page_number)) {
+        entry->fetch_and(~flag, std::memory_order_relaxed);
+    }
 }
 
-bool PageTable::isDirty(int page_number) const {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
+bool PageTable::getFlag(int page_number, PageTableEntry flag) const {
+    std::atomic<PageTableEntry>* entry = findEntry(page_number);
+    return entry && (entry->load(std::memory_order_relaxed) & flag) != 0;
+}
+
+int PageTable::getFrameNumber(int page_number) const {
+    std::atomic<PageTableEntry>* entry = findEntry(page_number);
+    if (!entry) return -1;
+
+    // check if present in memory; the zero page has no frame
+    PageTableEntry value = entry->load(std::memory_order_relaxed);
+    if ((value & (PRESENT | ZERO)) == PRESENT) {
+        return (int)(value >> FRAME_SHIFT);
     }
 
-    return entries[page_number].dirty_bit;
+    return -1;
+}
+
+bool PageTable::isPresent(int page_number) const {
+    return getFlag(page_number, PRESENT);
+}
+
+bool PageTable::isDirty(int page_number) const {
+    return getFlag(page_number, DIRTY);
 }
 
 void PageTable::setDirty(int page_number, bool is_dirty) {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
-    }
-    
-    entries[page_number].dirty_bit = is_dirty;
+    setFlag(page_number, DIRTY, is_dirty);
 }
 
+bool PageTable::isReferenced(int page_number) const {
+    return getFlag(page_number, REFERENCED);
+}
+
+void PageTable::setReferenced(int page_number, bool is_referenced) {
+    setFlag(page_number, REFERENCED, is_referenced);
+}
+
+bool PageTable::isReadahead(int page_number) const {
+    return getFlag(page_number, READAHEAD);
+}
+
+void PageTable::setReadahead(int page_number, bool is_readahead) {
+    setFlag(page_number, READAHEAD, is_readahead);
+}
+
+bool PageTable::isPrefetched(int page_number) const {
+    return getFlag(page_number, PREFETCHED);
+}
+
+void PageTable::setPrefetched(int page_number, bool is_prefetched) {
+    setFlag(page_number, PREFETCHED, is_prefetched);
+}
+
+bool PageTable::isInWindow(int page_number) const {
+    return getFlag(page_number, IN_WINDOW);
+}
+
+void PageTable::setInWindow(int page_number, bool in_window) {
+    setFlag(page_number, IN_WINDOW, in_window);
+}
+
+// The remapping functions rewrite the whole word but keep IN_WINDOW, which
+// belongs to the working-set window rather than the mapping. A referenced
+// bit cleared concurrently may be lost, which only costs the page a sweep.
 void PageTable::mapPageToFrame(int page_number, int frame_number) {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
+    if (frame_number < 0 || (size_t)frame_number >= MAX_FRAMES) {
+        throw std::out_of_range("Frame number does not fit in a page table entry.");
     }
 
-    entries[page_number].present_bit = true;
-    entries[page_number].frame_number = frame_number;
-    entries[page_number].dirty_bit = false; 
+    // loaded because it is about to be used, so referenced; clean
+    std::atomic<PageTableEntry>& entry = leafFor(page_number).entries[(size_t)page_number & leaf_mask];
+    PageTableEntry mapped = PRESENT | REFERENCED | ((PageTableEntry)frame_number << FRAME_SHIFT);
+    entry.store((entry.load(std::memory_order_relaxed) & IN_WINDOW) | mapped, std::memory_order_relaxed);
+}
+
+// The page reads as zeroes without a frame of its own; a write must fault
+// so the MemoryManager can give it one.
+void PageTable::mapZeroPage(int page_number) {
+    std::atomic<PageTableEntry>& entry = leafFor(page_number).entries[(size_t)page_number & leaf_mask];
+    entry.store((entry.load(std::memory_order_relaxed) & IN_WINDOW) | PRESENT | ZERO | REFERENCED,
+                std::memory_order_relaxed);
+}
+
+bool PageTable::isZeroPage(int page_number) const {
+    return getFlag(page_number, ZERO);
 }
 
 void PageTable::unmapPage(int page_number) {
-    if (page_number < 0 || page_number >= this->num_pages) {
-        throw std::out_of_range("Page number is out of the valid range for this process.");
+    std::atomic<PageTableEntry>* entry = findEntry(page_number);
+    if (!entry) return;
+
+    PageTableEntry frame_bits = ~(PageTableEntry)0 << FRAME_SHIFT;
+    entry->fetch_and(~(PRESENT | ZERO | frame_bits), std::memory_order_relaxed);
+}
+
+int PageTable::getSwapSlot(int page_number) const {
+    Leaf* leaf = directory[(size_t)page_number >> leaf_shift].load(std::memory_order_acquire);
+    if (!leaf || !leaf->swap_slots) return -1;
+
+    return leaf->swap_slots[(size_t)page_number & leaf_mask];
+}
+
+void PageTable::setSwapSlot(int page_number, int slot) {
+    int old_slot = getSwapSlot(page_number);
+    if (old_slot < 0 && slot < 0) return;
+
+    Leaf& leaf = leafFor(page_number);
+    if (!leaf.swap_slots) {
+        leaf.swap_slots.reset(new int[leaf.size]);
+        std::fill(leaf.swap_slots.get(), leaf.swap_slots.get() + leaf.size, -1);
+        table_bytes += leaf.size * sizeof(int);
     }
 
-    entries[page_number].present_bit = false;
-    entries[page_number].frame_number = -1;
+    if (old_slot < 0 && slot >= 0) swap_slot_count++;
+    if (old_slot >= 0 && slot < 0) swap_slot_count--;
+    leaf.swap_slots[(size_t)page_number & leaf_mask] = slot;
+}
+
+size_t PageTable::getNumPages() const {
+    return this->num_pages;
+}
+
+size_t PageTable::nextPopulatedPage(size_t page_number) const {
+    while (page_number < this->num_pages) {
+        size_t index = page_number >> leaf_shift;
+        if (directory[index].load(std::memory_order_acquire)) return page_number;
+        page_number = (index + 1) << leaf_shift;
+    }
+    return this->num_pages;
+}
+
+int PageTable::getLevels() const {
+    return this->levels;
+}
+
+size_t PageTable::getTableBytes() const {
+    return this->table_bytes.load();
+}
+
+int PageTable::getResidentHead() const {
+    return this->resident_head;
+}
+
+void PageTable::setResidentHead(int frame) {
+    this->resident_head = frame;
+}
+
+size_t PageTable::getResidentCount() const {
+    return this->resident_count;
+}
+
+void PageTable::setResidentCount(size_t count) {
+    this->resident_count = count;
+}
+
+size_t PageTable::getSwapSlotCount() const {
+    return this->swap_slot_count;
+}
+
+PageTable::ReadaheadState& PageTable::getReadaheadState() {
+    return this->readahead;
+}
+
+PageTable::WorkingSetState& PageTable::getWorkingSetState() {
+    return this->working_set;
+}
+
+size_t PageTable::getWorkingSetSize() const {
+    return this->working_set_size.load();
+}
+
+void PageTable::setWorkingSetSize(size_t pages) {
+    this->working_set_size = pages;
+}
+
+std::vector<int>& PageTable::getSwappedPages() {
+    return this->swapped_pages;
+}
+
+bool PageTable::isReleased() const {
+    return this->released;
+}
+
+void PageTable::setReleased(bool is_released) {
+    this->released = is_released;
+}
+
+bool PageTable::isFlatWaiting() const {
+    return this->flat_waiting;
+}
+
+void PageTable::setFlatWaiting(bool is_waiting) {
+    this->flat_waiting = is_waiting;
+}
+
+std::mutex& PageTable::getMutex() const {
+    return this->table_mutex;
 }
 
 size_t PageTable::getPageSize() const {
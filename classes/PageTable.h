@@ -2,31 +2,145 @@
 #pragma once
 
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <cstddef> // for size_t
+#include <memory>
 
 class PageTable {
 public:
     
-    struct PageTableEntry {
-        bool present_bit = false; // Is the page currently in a physical frame?
-        bool dirty_bit = false;   // Has the page been modified since being loaded?
-        int frame_number = -1;  // The physical frame number where the page is located.
+    // One page's entry, packed into a word: the flag bits below, then the
+    // frame number above FRAME_SHIFT. Zero is an unmapped, untouched page.
+    using PageTableEntry = uint32_t;
+    static constexpr PageTableEntry PRESENT = 1u << 0;     // in a physical frame (or the zero page)
+    static constexpr PageTableEntry DIRTY = 1u << 1;       // modified since being loaded
+    static constexpr PageTableEntry REFERENCED = 1u << 2;  // accessed since the replacement policy last cleared it
+    static constexpr PageTableEntry READAHEAD = 1u << 3;   // brought in by read-ahead and not accessed yet
+    static constexpr PageTableEntry PREFETCHED = 1u << 4;  // prefetched at dispatch and not accessed yet
+    static constexpr PageTableEntry ZERO = 1u << 5;        // mapped to the shared, read-only zero page (no frame)
+    static constexpr PageTableEntry IN_WINDOW = 1u << 6;   // touched in the current working-set window
+    static constexpr unsigned FRAME_SHIFT = 7;
+    static constexpr size_t MAX_FRAMES = (size_t)1 << (32 - FRAME_SHIFT);
+
+    // With two levels, a directory of leaf tables of LEAF_PAGES entries
+    // each; a leaf is only allocated once one of its pages is mapped or
+    // given a swap slot, so a sparse address space costs little.
+    static constexpr unsigned LEAF_SHIFT = 10;
+    static constexpr size_t LEAF_PAGES = (size_t)1 << LEAF_SHIFT;
+
+    // Sequential fault detection for read-ahead, kept by the MemoryManager
+    // under table_mutex.
+    struct ReadaheadState {
+        int next_page = -1;     // page after the last cluster brought in
+        size_t window = 0;      // pages to read ahead on the next sequential fault
+    };
+
+    // Working-set window, kept by the MemoryManager under table_mutex: the
+    // pages touched since window_start, each once and marked IN_WINDOW.
+    struct WorkingSetState {
+        std::vector<int> touched;
+        bool started = false;   // no window until the first reference
+        uint64_t window_start = 0;
     };
 
 private:
-    std::vector<PageTableEntry> entries;
+    struct Leaf {
+        std::unique_ptr<std::atomic<PageTableEntry>[]> entries;
+        std::unique_ptr<int[]> swap_slots;     // allocated with the leaf's first slot
+        size_t size;
+    };
+
+    // Entries are atomic so the referenced bit can be set and cleared
+    // without table_mutex while other bits in the word change under it.
+    // A single-level table is one leaf covering every page, allocated up
+    // front; leaf_shift is then wide enough that every page lands in it.
+    std::unique_ptr<std::atomic<Leaf*>[]> directory;
+    size_t num_leaves;
+    unsigned leaf_shift;
+    size_t leaf_mask;
+    int levels;
+    std::atomic<size_t> table_bytes{0};
     size_t num_pages;
     size_t page_size;
+    // First frame of this process's resident list, linked through
+    // Frame::next_resident. Maintained by the MemoryManager.
+    int resident_head = -1;
+    size_t resident_count = 0;
+    size_t swap_slot_count = 0;     // pages with a backing store slot
+    // Held by the MemoryManager while it maps, unmaps, reads or writes this
+    // table's pages. The referenced bit is advisory and may be set without it.
+    mutable std::mutex table_mutex;
+    ReadaheadState readahead;
+    bool released = false;          // the process's memory was handed back; map nothing more
+    bool flat_waiting = false;      // its flat block did not fit; the next try is a retry
+    WorkingSetState working_set;
+    // Pages touched in the last full window, or in the current one if that
+    // is more. Read by the scheduler without the lock; 0 before any reference.
+    std::atomic<size_t> working_set_size{0};
+    // Pages the medium-term swapper wrote out together, in page order, to
+    // be loaded back together when the process is readmitted.
+    std::vector<int> swapped_pages;
+
+    // The page's entry, or nullptr if its leaf was never allocated.
+    std::atomic<PageTableEntry>* findEntry(int page_number) const;
+    Leaf& leafFor(int page_number);
+    void setFlag(int page_number, PageTableEntry flag, bool on);
+    bool getFlag(int page_number, PageTableEntry flag) const;
 
 public:
-    PageTable(size_t process_memory_size, size_t page_size);
+    // levels is 1 (one flat array of entries) or 2 (leaves on demand).
+    PageTable(size_t process_memory_size, size_t page_size, int levels = 1);
+    ~PageTable();
+
+    // The per-page accessors below do not range-check page_number; the
+    // MemoryManager validates a page once where it enters, with checkPage.
+    bool isValidPage(int page_number) const;
+    // Throws std::out_of_range unless isValidPage(page_number).
+    void checkPage(int page_number) const;
 
     int getFrameNumber(int page_number) const;
     bool isPresent(int page_number) const;
     bool isDirty(int page_number) const;
     void setDirty(int page_number, bool is_dirty);
+    bool isReferenced(int page_number) const;
+    void setReferenced(int page_number, bool is_referenced);
+    bool isReadahead(int page_number) const;
+    void setReadahead(int page_number, bool is_readahead);
+    bool isPrefetched(int page_number) const;
+    void setPrefetched(int page_number, bool is_prefetched);
+    bool isInWindow(int page_number) const;
+    void setInWindow(int page_number, bool in_window);
     void mapPageToFrame(int page_number, int frame_number);
+    void mapZeroPage(int page_number);
+    bool isZeroPage(int page_number) const;
     void unmapPage(int page_number);
+    int getSwapSlot(int page_number) const;
+    void setSwapSlot(int page_number, int slot);
+
+    size_t getNumPages() const;
+    // The first page at or after page_number whose leaf exists, or
+    // getNumPages(); pages in between have never been mapped or swapped.
+    size_t nextPopulatedPage(size_t page_number) const;
+    int getLevels() const;
+    // Bytes held by the directory, leaves and swap-slot arrays.
+    size_t getTableBytes() const;
+    int getResidentHead() const;
+    void setResidentHead(int frame);
+    size_t getResidentCount() const;
+    void setResidentCount(size_t count);
+    size_t getSwapSlotCount() const;
+    ReadaheadState& getReadaheadState();
+    WorkingSetState& getWorkingSetState();
+    size_t getWorkingSetSize() const;
+    void setWorkingSetSize(size_t pages);
+    std::vector<int>& getSwappedPages();
+    bool isReleased() const;
+    void setReleased(bool is_released);
+    bool isFlatWaiting() const;
+    void setFlatWaiting(bool is_waiting);
+    std::mutex& getMutex() const;
 
     size_t getPageSize() const; 
 };
\ No newline at end of file
@@ -0,0 +1,220 @@
+// ReplacementPolicy.cpp
+#include "ReplacementPolicy.h"
+#include <algorithm>
+
+// --- FIFO ---
+
+void FifoPolicy::unlink(int frame) {
+    if (prev[frame] >= 0) next[prev[frame]] = next[frame]; else head = next[frame];
+    if (next[frame] >= 0) prev[next[frame]] = prev[frame]; else tail = prev[frame];
+    prev[frame] = next[frame] = -1;
+    queued[frame] = false;
+}
+
+void FifoPolicy::frameLoaded(int frame) {
+    if (queued[frame]) unlink(frame);
+    prev[frame] = tail;
+    next[frame] = -1;
+    if (tail >= 0) next[tail] = frame; else head = frame;
+    tail = frame;
+    queued[frame] = true;
+}
+
+void FifoPolicy::frameFreed(int frame) {
+    if (queued[frame]) unlink(frame);
+}
+
+int FifoPolicy::selectVictim(FrameInspector& frames) {
+    for (int frame = head; frame >= 0; frame = next[frame]) {
+        if (frames.isEvictable(frame)) {
+            unlink(frame);
+            return frame;
+        }
+    }
+    return -1;
+}
+
+// It was the oldest evictable frame, so it goes back to the front.
+void FifoPolicy::frameSkipped(int frame) {
+    if (queued[frame]) return;
+    prev[frame] = -1;
+    next[frame] = head;
+    if (head >= 0) prev[head] = frame; else tail = frame;
+    head = frame;
+    queued[frame] = true;
+}
+
+void FifoPolicy::peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) {
+    for (int frame = head; frame >= 0 && out.size() < count; frame = next[frame]) {
+        if (frames.isEvictable(frame)) out.push_back(frame);
+    }
+}
+
+// --- Clock ---
+
+void ClockPolicy::frameLoaded(int frame) {
+    in_use[frame] = true;
+}
+
+void ClockPolicy::frameFreed(int frame) {
+    in_use[frame] = false;
+}
+
+int ClockPolicy::selectVictim(FrameInspector& frames) {
+    // Two sweeps: the first may only clear referenced bits.
+    for (size_t step = 0; step < 2 * num_frames; ++step) {
+        int frame = (int)hand;
+        hand = (hand + 1) % num_frames;
+        if (!in_use[frame] || !frames.isEvictable(frame)) continue;
+        if (frames.isReferenced(frame, true)) continue;
+        return frame;
+    }
+    return -1;
+}
+
+void ClockPolicy::peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) {
+    for (size_t step = 0; step < num_frames && out.size() < count; ++step) {
+        int frame = (int)((hand + step) % num_frames);
+        if (in_use[frame] && frames.isEvictable(frame) && !frames.isReferenced(frame, false)) {
+            out.push_back(frame);
+        }
+    }
+}
+
+// --- LRU (aging) ---
+
+void LruAgingPolicy::ageFrames(FrameInspector& frames) {
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (!in_use[frame]) continue;
+        age[frame] = (uint8_t)((age[frame] >> 1) | (frames.isReferenced((int)frame, true) ? 0x80 : 0));
+    }
+}
+
+void LruAgingPolicy::frameLoaded(int frame) {
+    in_use[frame] = true;
+    age[frame] = 0;
+}
+
+void LruAgingPolicy::frameFreed(int frame) {
+    in_use[frame] = false;
+}
+
+void LruAgingPolicy::startEviction(FrameInspector& frames) {
+    ageFrames(frames);
+}
+
+int LruAgingPolicy::selectVictim(FrameInspector& frames) {
+    int victim = -1;
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (!in_use[frame] || !frames.isEvictable((int)frame)) continue;
+        if (victim < 0 || age[frame] < age[victim]) victim = (int)frame;
+    }
+    return victim;
+}
+
+void LruAgingPolicy::peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) {
+    std::vector<int> candidates;
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (in_use[frame] && frames.isEvictable((int)frame)) candidates.push_back((int)frame);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [this](int a, int b) { return age[a] < age[b]; });
+    candidates.resize(std::min(count, candidates.size()));
+    out.insert(out.end(), candidates.begin(), candidates.end());
+}
+
+// --- LFU ---
+
+void LfuPolicy::countUses(FrameInspector& frames) {
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (in_use[frame] && frames.isReferenced((int)frame, true)) uses[frame]++;
+    }
+}
+
+void LfuPolicy::frameLoaded(int frame) {
+    in_use[frame] = true;
+    uses[frame] = 0;
+}
+
+void LfuPolicy::frameFreed(int frame) {
+    in_use[frame] = false;
+}
+
+void LfuPolicy::startEviction(FrameInspector& frames) {
+    countUses(frames);
+}
+
+int LfuPolicy::selectVictim(FrameInspector& frames) {
+    int victim = -1;
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (!in_use[frame] || !frames.isEvictable((int)frame)) continue;
+        if (victim < 0 || uses[frame] < uses[victim]) victim = (int)frame;
+    }
+    return victim;
+}
+
+void LfuPolicy::peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) {
+    std::vector<int> candidates;
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+        if (in_use[frame] && frames.isEvictable((int)frame)) candidates.push_back((int)frame);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [this](int a, int b) { return uses[a] < uses[b]; });
+    candidates.resize(std::min(count, candidates.size()));
+    out.insert(out.end(), candidates.begin(), candidates.end());
+}
+
+// --- WSClock ---
+
+void WsClockPolicy::frameLoaded(int frame) {
+    in_use[frame] = true;
+    last_use[frame] = g_cpu_tick;
+}
+
+void WsClockPolicy::frameFreed(int frame) {
+    in_use[frame] = false;
+}
+
+int WsClockPolicy::selectVictim(FrameInspector& frames) {
+    const uint64_t now = g_cpu_tick;
+    int dirty_candidate = -1;
+    int oldest = -1;
+
+    for (size_t step = 0; step < num_frames; ++step) {
+        int frame = (int)hand;
+        hand = (hand + 1) % num_frames;
+        if (!in_use[frame] || !frames.isEvictable(frame)) continue;
+
+        if (frames.isReferenced(frame, true)) {
+            last_use[frame] = now;
+        } else if (now - last_use[frame] > WORKING_SET_TICKS) {
+            if (!frames.isDirty(frame)) return frame;
+            if (dirty_candidate < 0) dirty_candidate = frame;
+        }
+        if (oldest < 0 || last_use[frame] < last_use[oldest]) oldest = frame;
+    }
+
+    // Nothing clean outside the working set: take an old dirty page, or
+    // failing that the least recently used one.
+    return dirty_candidate >= 0 ? dirty_candidate : oldest;
+}
+
+void WsClockPolicy::peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) {
+    const uint64_t now = g_cpu_tick;
+    for (size_t step = 0; step < num_frames && out.size() < count; ++step) {
+        int frame = (int)((hand + step) % num_frames);
+        if (in_use[frame] && frames.isEvictable(frame) && !frames.isReferenced(frame, false) &&
+            now - last_use[frame] > WORKING_SET_TICKS) {
+            out.push_back(frame);
+        }
+    }
+}
+
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name, size_t num_frames) {
+    if (name == "fifo") return std::make_unique<FifoPolicy>(num_frames);
+    if (name == "clock") return std::make_unique<ClockPolicy>(num_frames);
+    if (name == "lru") return std::make_unique<LruAgingPolicy>(num_frames);
+    if (name == "lfu") return std::make_unique<LfuPolicy>(num_frames);
+    if (name == "wsclock") return std::make_unique<WsClockPolicy>(num_frames);
+    return nullptr;
+}
@@ -0,0 +1,151 @@
+// ReplacementPolicy.h
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What a replacement policy may ask the MMU about a frame. Every call is
+// made with the policy's shard lock held.
+class FrameInspector {
+public:
+    virtual ~FrameInspector() = default;
+    // Holds a page and is not being refilled by a fault.
+    virtual bool isEvictable(int frame) = 0;
+    // The referenced bit of the page in frame, cleared afterwards if clear.
+    virtual bool isReferenced(int frame, bool clear) = 0;
+    virtual bool isDirty(int frame) = 0;
+};
+
+// Picks which resident page to evict. The MMU tells the policy when a frame
+// is filled or freed; the policy keeps whatever per-frame state it needs.
+// The MMU runs one policy per shard of frames, each only touched with that
+// shard's lock held; frame numbers passed to a policy are shard-local.
+class ReplacementPolicy {
+protected:
+    size_t num_frames;
+
+public:
+    explicit ReplacementPolicy(size_t num_frames) : num_frames(num_frames) {}
+    virtual ~ReplacementPolicy() = default;
+
+    virtual std::string getName() const = 0;
+    virtual void frameLoaded(int frame) = 0;
+    virtual void frameFreed(int frame) = 0;
+    // Called once per eviction, before the first selectVictim, however many
+    // picks turn out busy. Policies that age or count references do it here.
+    virtual void startEviction(FrameInspector& /*frames*/) {}
+    // Returns the frame to evict, or -1 if no frame is evictable right now.
+    virtual int selectVictim(FrameInspector& frames) = 0;
+    // The frame selectVictim returned could not be taken after all; put it
+    // back exactly as it was.
+    virtual void frameSkipped(int /*frame*/) {}
+    // Up to count frames likely to be picked next, without disturbing any
+    // state. The writeback daemon cleans these ahead of time.
+    virtual void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) = 0;
+};
+
+// Evicts in load order. Suffers Belady's anomaly but needs no reference
+// information. The queue is a doubly linked list threaded through per-frame
+// arrays, so a freed frame leaves it in O(1).
+class FifoPolicy : public ReplacementPolicy {
+private:
+    std::vector<int> prev;
+    std::vector<int> next;
+    std::vector<bool> queued;
+    int head = -1;
+    int tail = -1;
+
+    void unlink(int frame);
+
+public:
+    explicit FifoPolicy(size_t num_frames)
+        : ReplacementPolicy(num_frames), prev(num_frames, -1), next(num_frames, -1), queued(num_frames, false) {}
+    std::string getName() const override { return "fifo"; }
+    void frameLoaded(int frame) override;
+    void frameFreed(int frame) override;
+    int selectVictim(FrameInspector& frames) override;
+    void frameSkipped(int frame) override;
+    void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) override;
+};
+
+// Second chance: a hand sweeps the frames, clearing referenced bits, and
+// evicts the first page it finds unreferenced.
+class ClockPolicy : public ReplacementPolicy {
+private:
+    std::vector<bool> in_use;
+    size_t hand = 0;
+
+public:
+    explicit ClockPolicy(size_t num_frames) : ReplacementPolicy(num_frames), in_use(num_frames, false) {}
+    std::string getName() const override { return "clock"; }
+    void frameLoaded(int frame) override;
+    void frameFreed(int frame) override;
+    int selectVictim(FrameInspector& frames) override;
+    void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) override;
+};
+
+// Approximate LRU by aging: on every eviction each frame's 8-bit age is shifted
+// right with its referenced bit entering at the top. The lowest age goes.
+class LruAgingPolicy : public ReplacementPolicy {
+private:
+    std::vector<bool> in_use;
+    std::vector<uint8_t> age;
+
+    void ageFrames(FrameInspector& frames);
+
+public:
+    explicit LruAgingPolicy(size_t num_frames)
+        : ReplacementPolicy(num_frames), in_use(num_frames, false), age(num_frames, 0) {}
+    std::string getName() const override { return "lru"; }
+    void frameLoaded(int frame) override;
+    void frameFreed(int frame) override;
+    void startEviction(FrameInspector& frames) override;
+    int selectVictim(FrameInspector& frames) override;
+    void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) override;
+};
+
+// Approximate LFU: on every eviction each frame's count grows by its referenced
+// bit. The least-used page since it was loaded goes.
+class LfuPolicy : public ReplacementPolicy {
+private:
+    std::vector<bool> in_use;
+    std::vector<uint32_t> uses;
+
+    void countUses(FrameInspector& frames);
+
+public:
+    explicit LfuPolicy(size_t num_frames)
+        : ReplacementPolicy(num_frames), in_use(num_frames, false), uses(num_frames, 0) {}
+    std::string getName() const override { return "lfu"; }
+    void frameLoaded(int frame) override;
+    void frameFreed(int frame) override;
+    void startEviction(FrameInspector& frames) override;
+    int selectVictim(FrameInspector& frames) override;
+    void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) override;
+};
+
+// WSClock: a clock over frames that also remembers when each page was last
+// seen referenced. Pages outside the working set (unreferenced for more
+// than WORKING_SET_TICKS) are evicted, clean ones first; dirty ones are left
+// for the writeback daemon if possible.
+class WsClockPolicy : public ReplacementPolicy {
+private:
+    static const uint64_t WORKING_SET_TICKS = 100;
+    std::vector<bool> in_use;
+    std::vector<uint64_t> last_use;
+    size_t hand = 0;
+
+public:
+    explicit WsClockPolicy(size_t num_frames)
+        : ReplacementPolicy(num_frames), in_use(num_frames, false), last_use(num_frames, 0) {}
+    std::string getName() const override { return "wsclock"; }
+    void frameLoaded(int frame) override;
+    void frameFreed(int frame) override;
+    int selectVictim(FrameInspector& frames) override;
+    void peekVictims(size_t count, FrameInspector& frames, std::vector<int>& out) override;
+};
+
+// Returns nullptr for an unknown name.
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(const std::string& name, size_t num_frames);
@@ -1,5 +1,6 @@
 #include "process.cpp"
 #include "MemoryManager.h"
+#include "TimerWheel.h"
 #include <queue>
 #include <string>
 #include <vector>
@@ -12,20 +13,31 @@
 #include <algorithm>
 #include <unordered_map>
 #include <exception>
+#include <functional>
 #include <windows.h>
 
 class Scheduler { 
 
     private:
+    // Per-core state. Each core owns a local run queue and the slot for the
+    // process it is currently running, both guarded by the core's own mutex,
+    // so dispatch never touches queueMutex. Idle cores steal from busy ones.
+    struct CoreQueue {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::unique_ptr<Process>> ready;
+        std::unique_ptr<Process> running;
+        std::atomic<size_t> depth{0};   // ready.size(), readable without the lock
+    };
+
     std::vector<std::unique_ptr<Process>> processes;
-    std::deque<std::unique_ptr<Process>> ready_queue;
-    std::vector<std::unique_ptr<Process>> runningProcesses;
+    std::vector<std::unique_ptr<CoreQueue>> cores;
+    std::atomic<size_t> next_core{0};       // round-robin start for queueProcesses
     std::vector<std::unique_ptr<Process>> completedProcesses;
     std::vector<std::thread> workerThreads;
     std::atomic<bool> schedulerRunning{false};
     std::atomic<bool> generatingProcesses{false};            // i think we only need one flag right??
-    std::mutex queueMutex;
-    std::condition_variable queueCV;
+    std::mutex queueMutex;          // guards processes, completedProcesses, process_registry and admission
     std::string SchedulerType;
     int quantumCycles; 
     uint16_t programcounter = 0;
@@ -34,259 +46,678 @@ class Scheduler {
     std::atomic<size_t> active_cpu_ticks{0};
     std::atomic<size_t> idle_cpu_ticks{0};
 
-    // Every process ever created, keyed by PID, so the MMU can reach the owner
-    // of an evicted frame regardless of which container currently holds it.
+    // Processes parked by SLEEP, keyed by wake-up tick. Their cores move on
+    // straight away; advanceTimers() puts them back on a run queue.
+    TimerWheel<std::unique_ptr<Process>> sleepers;
+    std::mutex sleepMutex;
+    std::thread tickerThread;
+
+    // Processes BLOCKED on a page fault. The pager thread brings their pages
+    // in one at a time, front first, and puts them back on a run queue; the
+    // faulting core dispatches someone else meanwhile. In turbo mode the page
+    // is mapped on the spot and the process waits PAGE_IN_TICKS on the timer
+    // wheel instead.
+    static const uint64_t PAGE_IN_TICKS = 1;
+    std::deque<std::unique_ptr<Process>> page_ins;
+
+    // Dispatch looks PREFETCH_LOOKAHEAD instructions ahead of the process
+    // and asks for the pages its READ/WRITEs will need. The pager serves
+    // these after any page-ins; in turbo mode they are loaded on the spot.
+    static const size_t PREFETCH_LOOKAHEAD = 16;
+    static const size_t MAX_PENDING_PREFETCHES = 64;
+    struct Prefetch {
+        Process* process;
+        int page;
+    };
+    std::deque<Prefetch> prefetches;
+    std::mutex pagerMutex;
+    std::condition_variable pagerCv;
+    std::thread pagerThread;
+
+    // Admission control: new processes wait in `suspended`, in arrival
+    // order, until their working sets fit in physical memory next to those
+    // already admitted, and not while the MMU reports thrashing. Nobody is
+    // held back while there are fewer admitted processes than cores
+    // (admissionFloor). A process stays admitted until it leaves the system.
+    // Admission only re-runs when `admitted` or the thrashing flag changes.
+    static const size_t ADMISSION_LOOKAHEAD = 64;
+    struct Admission {
+        Process* process;
+        size_t estimate;    // working set guessed at admission, before it ran
+    };
+    std::deque<std::unique_ptr<Process>> suspended;
+    std::vector<Admission> admitted;
+    std::atomic<size_t> admission_deferrals{0};
+    std::atomic<bool> admitted_while_thrashing{false};  // the flag admission last saw
+
+    // Medium-term swapper: when free frames are below 1/SWAP_WATERMARK of
+    // memory and the MMU reports thrashing, the process that would wait
+    // longest for a core (the back of the deepest run queue) is swapped out
+    // whole and suspended; admission swaps it back in. Memory only frees up
+    // when processes leave, so the watermark alone would fire on every
+    // fault once memory fills.
+    static const size_t SWAP_WATERMARK = 8;
+    static const size_t MAX_SWAP_OUTS = 2;     // per fault, and queued at once
+
+    // Whole-process swaps waiting on the pager, which does their I/O with no
+    // scheduler lock held. Guarded by pagerMutex. A process in swap_outs has
+    // left `admitted` and goes to `suspended` once written out; one in
+    // swap_ins is admitted and goes to a run queue once read back in.
+    std::deque<std::unique_ptr<Process>> swap_outs;
+    std::deque<std::unique_ptr<Process>> swap_ins;
+
+    // Every process ever created, keyed by PID, regardless of which container
+    // currently holds it.
     std::unordered_map<int, Process*> process_registry;
+    // Parents forkParked has taken out of their queue while it copies them.
+    // Guarded by queueMutex.
+    std::vector<Process*> forking;
+
+    // Moves half of the longest other queue into coreId's queue.
+    // Steals from the back so the victim keeps popping its front undisturbed.
+    bool stealWork(int coreId) {
+        CoreQueue& self = *cores[coreId];
+        int victim = -1;
+        size_t best = 0;
+        for (size_t i = 1; i < cores.size(); ++i) {
+            int candidate = (coreId + (int)i) % (int)cores.size();
+            size_t depth = cores[candidate]->depth.load(std::memory_order_relaxed);
+            if (depth > best) {
+                best = depth;
+                victim = candidate;
+            }
+        }
+        if (victim == -1) return false;
+
+        CoreQueue& other = *cores[victim];
+        std::scoped_lock lock(self.mutex, other.mutex);
+        size_t count = (other.ready.size() + 1) / 2;
+        for (size_t i = 0; i < count; ++i) {
+            self.ready.push_front(std::move(other.ready.back()));
+            other.ready.pop_back();
+        }
+        other.depth = other.ready.size();
+        self.depth = self.ready.size();
+        return count > 0;
+    }
 
-    void fcfs_scheduler(int coreId) {
-        while (this->schedulerRunning) {
-            std::unique_ptr<Process> current_process;
-
-              {
-                std::unique_lock<std::mutex> lock(this->queueMutex);
-                if (this->queueCV.wait_for(lock, std::chrono::milliseconds(10), [this] { 
-                    return !this->ready_queue.empty() || !this->schedulerRunning; 
-                })) {
-                    if (!this->schedulerRunning && this->ready_queue.empty()) {
-                        break;
-                    }
-                    current_process = std::move(this->ready_queue.front());
-                    this->ready_queue.pop_front();
-                } else {
-                    idle_cpu_ticks++;
-                    continue;
-                }
-            }   
-
-            // process execution
-            if (current_process) {
-                current_process->setState(ProcessState::RUNNING);
-                current_process->setCurrentCoreId(coreId);
-                
-                while(current_process->getProgramCounter() < current_process->getInstructionCount()) {
-                    if (!executeInstruction(*current_process)) {
-                        break; 
-                    }
-                    active_cpu_ticks++;
-                }
-                    
-                if (current_process->getState() != ProcessState::TERMINATED) {
-                    current_process->setState(ProcessState::FINISHED);
-                }
-
-                // Return this process's frames to the free list before it is
-                // filed away. Kept outside queueMutex to preserve lock ordering.
-                mmu->releaseProcessMemory(current_process->getPid());
+    // Puts the next process for coreId in its running slot, from the local
+    // queue or stolen from another core. Never blocks.
+    Process* takeNext(int coreId) {
+        CoreQueue& core = *cores[coreId];
 
-                {
-                    std::lock_guard<std::mutex> lock(this->queueMutex);
-                    this->completedProcesses.push_back(std::move(current_process));
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            {
+                std::lock_guard<std::mutex> lock(core.mutex);
+                if (!core.ready.empty()) {
+                    core.running = std::move(core.ready.front());
+                    core.ready.pop_front();
+                    core.depth = core.ready.size();
+                    core.running->setCurrentCoreId(coreId);
+                    return core.running.get();
                 }
             }
+            if (!stealWork(coreId)) break;
         }
-        std::cout << "Core " << coreId << ": Exiting FCFS worker thread." << std::endl;
+        return nullptr;
     }
 
-    void rr_scheduler(int coreId){
-          while (this->schedulerRunning) {
-            std::unique_ptr<Process> current_process;
+    // Worker-thread version of takeNext: waits up to one poll interval for
+    // work before giving up.
+    Process* dispatch(int coreId) {
+        if (Process* process = takeNext(coreId)) return process;
+
+        CoreQueue& core = *cores[coreId];
+        std::unique_lock<std::mutex> lock(core.mutex);
+        core.cv.wait_for(lock, std::chrono::milliseconds(10), [&] {
+            return !core.ready.empty() || !this->schedulerRunning;
+        });
+        return nullptr;
+    }
+
+    // Sends the core's running process to the back of the same core's queue.
+    void preempt(int coreId) {
+        CoreQueue& core = *cores[coreId];
+        std::lock_guard<std::mutex> lock(core.mutex);
+        core.running->setState(ProcessState::WAITING);
+        core.running->setCurrentCoreId(-1);
+        core.ready.push_back(std::move(core.running));
+        core.depth = core.ready.size();
+    }
+
+    // Moves the core's running process, which has just executed SLEEP, onto
+    // the timer wheel. Returns its wake-up tick.
+    uint64_t park(int coreId) {
+        CoreQueue& core = *cores[coreId];
+        std::scoped_lock lock(core.mutex, this->sleepMutex);
+        uint64_t wake_tick = core.running->getWakeTick();
+        core.running->setCurrentCoreId(-1);
+        this->sleepers.schedule(wake_tick, std::move(core.running));
+        return wake_tick;
+    }
+
+    // Queues ready processes for swap-out while memory is short, never below
+    // the admission floor, so admitted processes remain to leave the system
+    // later and let them back in. Only the queues change here; the pager
+    // writes the pages out.
+    void swapOutIdle() {
+        size_t frames = mmu->getTotalMemory() / mmu->getPageSize();
+        size_t watermark = std::max<size_t>(1, frames / SWAP_WATERMARK);
+
+        for (size_t n = 0; n < MAX_SWAP_OUTS; ++n) {
+            if (mmu->getFreeMemory() / mmu->getPageSize() >= watermark || !mmu->isThrashing()) return;
 
+            std::unique_lock<std::mutex> lock(this->queueMutex);
             {
-                std::unique_lock<std::mutex> lock(this->queueMutex);
-                if (this->queueCV.wait_for(lock, std::chrono::milliseconds(10), [this] { 
-                    return !this->ready_queue.empty() || !this->schedulerRunning; 
-                })) {
-                    if (!this->schedulerRunning && this->ready_queue.empty()) {
-                        break;
-                    }
-                    current_process = std::move(this->ready_queue.front());
-                    this->ready_queue.pop_front();
-
-                    this->runningProcesses.push_back(std::move(current_process));
-                } else {
-                    idle_cpu_ticks++;
-                    continue;
-                }
-            } 
+                // Frames queued to be freed have not shown up as free yet.
+                std::lock_guard<std::mutex> pager_lock(pagerMutex);
+                if (swap_outs.size() >= MAX_SWAP_OUTS) return;
+            }
+            if (admitted.size() <= admissionFloor()) return;
+            size_t deepest = 0;
+            for (size_t i = 1; i < cores.size(); ++i) {
+                if (cores[i]->depth > cores[deepest]->depth) deepest = i;
+            }
 
-            Process* process_to_run = nullptr;
+            CoreQueue& core = *cores[deepest];
+            std::unique_ptr<Process> victim;
             {
-                std::lock_guard<std::mutex> lock(this->queueMutex);
-    
-                for(auto& p : runningProcesses) {
-                    if (p->getCurrentCoreId() == -1) { // Find one that hasn't been assigned a core yet
-                        process_to_run = p.get();
-                        process_to_run->setCurrentCoreId(coreId);
-                        break;
-                    }
+                std::lock_guard<std::mutex> core_lock(core.mutex);
+                if (core.ready.empty()) return;
+                victim = std::move(core.ready.back());
+                core.ready.pop_back();
+                core.depth = core.ready.size();
+            }
+            for (size_t i = 0; i < admitted.size(); ++i) {
+                if (admitted[i].process == victim.get()) {
+                    admitted.erase(admitted.begin() + i);
+                    break;
                 }
             }
+            {
+                std::lock_guard<std::mutex> pager_lock(pagerMutex);
+                swap_outs.push_back(std::move(victim));
+            }
+            lock.unlock();
+            pagerCv.notify_one();
+        }
+    }
+
+    // Does the I/O for queued whole-process swaps, swap-ins first, holding
+    // no scheduler lock while it runs. Only the pager calls this, or the
+    // turbo loop between events, so the fronts stay put while unlocked and
+    // remain visible to getAllProcesses.
+    void serviceSwaps() {
+        std::unique_lock<std::mutex> lock(this->pagerMutex);
+        while (!swap_ins.empty() || !swap_outs.empty()) {
+            if (!swap_ins.empty()) {
+                Process& process = *swap_ins.front();
+                lock.unlock();
+                mmu->swapInProcess(process);
+                lock.lock();
+                std::unique_ptr<Process> done = std::move(swap_ins.front());
+                swap_ins.pop_front();
+                lock.unlock();
+                enqueue(std::move(done));
+                lock.lock();
+                continue;
+            }
+
+            Process& process = *swap_outs.front();
+            lock.unlock();
+            size_t pages = mmu->swapOutProcess(process);
+            std::lock_guard<std::mutex> queue_lock(this->queueMutex);
+            lock.lock();
+            std::unique_ptr<Process> done = std::move(swap_outs.front());
+            swap_outs.pop_front();
+            lock.unlock();
+            if (pages == 0) {
+                // Nothing resident to give back; it keeps its place.
+                admitted.push_back({done.get(), mmu->getWorkingSet(*done)});
+                enqueue(std::move(done));
+            } else {
+                done->setState(ProcessState::SUSPENDED);
+                suspended.push_back(std::move(done));
+                admitSuspended();
+            }
+            lock.lock();
+        }
+    }
+
+    // Takes the core's running process, which has just faulted, off the CPU
+    // until its page is in.
+    void blockForPage(int coreId) {
+        CoreQueue& core = *cores[coreId];
+        std::unique_ptr<Process> process;
+        {
+            std::lock_guard<std::mutex> lock(core.mutex);
+            core.running->setCurrentCoreId(-1);
+            process = std::move(core.running);
+        }
+        swapOutIdle();
+
+        if (g_virtual_time) {
+            try {
+                mmu->handlePageFault(*process, process->getBlockedPage(), process->isBlockedOnWrite());
+            } catch (const std::exception& e) {
+                std::cerr << "[Scheduler] Exception while paging in PID " << process->getPid()
+                          << ": " << e.what() << std::endl;
+                process->terminate(std::string("Internal error: ") + e.what());
+                fileCompleted(std::move(process));
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(this->sleepMutex);
+                this->sleepers.schedule(g_cpu_tick + PAGE_IN_TICKS, std::move(process));
+            }
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(this->pagerMutex);
+                this->page_ins.push_back(std::move(process));
+            }
+            pagerCv.notify_one();
+        }
+
+        // Thrashing starting or stopping changes who may be admitted.
+        if (mmu->isThrashing() != admitted_while_thrashing) {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            admitSuspended();
+        }
+    }
+
+    // Queues prefetches for the pages a just-dispatched process is about to
+    // touch. Never waits for them.
+    void prefetchUpcoming(Process& process) {
+        std::vector<int> pages;
+        process.getUpcomingPages(PREFETCH_LOOKAHEAD, pages);
+        PageTable* page_table = process.getPageTable();
+
+        if (g_virtual_time) {
+            for (int page : pages) {
+                if (!page_table->isPresent(page)) mmu->prefetchPage(process, page);
+            }
+            return;
+        }
+
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(this->pagerMutex);
+            for (int page : pages) {
+                if (this->prefetches.size() >= MAX_PENDING_PREFETCHES) break;
+                if (page_table->isPresent(page)) continue;
+                this->prefetches.push_back({&process, page});
+                queued = true;
+            }
+        }
+        if (queued) pagerCv.notify_one();
+    }
+
+    // Puts a runnable process on the least loaded core's queue.
+    void enqueue(std::unique_ptr<Process> process) {
+        size_t target = next_core++ % cores.size();
+        for (size_t i = 0; i < cores.size(); ++i) {
+            if (cores[i]->depth < cores[target]->depth) target = i;
+        }
 
-            if (process_to_run) {
-                process_to_run->setState(ProcessState::RUNNING);
+        CoreQueue& core = *cores[target];
+        {
+            std::lock_guard<std::mutex> lock(core.mutex);
+            core.ready.push_back(std::move(process));
+            core.depth = core.ready.size();
+        }
+        core.cv.notify_one();
+    }
 
-                unsigned int slice = std::min<unsigned>(
-                    process_to_run->getRemainingBurst(),
-                    (unsigned int)this->quantumCycles
-                );
+    // Steps the timer wheel to tick and requeues every sleeper due by then.
+    // Returns how many woke.
+    size_t advanceTimers(uint64_t tick) {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        std::vector<std::unique_ptr<Process>> woken;
+        this->sleepers.advance(tick, woken);
+        for (auto& process : woken) {
+            if (process->getState() == ProcessState::BLOCKED) {
+                process->pageArrived();
+            } else {
+                process->wakeUp();
+            }
+            enqueue(std::move(process));
+        }
+        return woken.size();
+    }
+
+    // Memory snapshots are labelled with the number of quantum cycles
+    // completed; the changes since the last boundary belong to this one.
+    void sealSnapshot(uint64_t tick) {
+        uint64_t quantum_ticks = (uint64_t)std::max(1, this->quantumCycles);
+        if (tick % quantum_ticks == 0) mmu->sealSnapshot(tick / quantum_ticks, tick);
+    }
+
+    // Real-time clock for the worker threads: one g_cpu_tick per TICK_MS.
+    // It also closes each quantum's memory snapshot, so the cores never do.
+    void ticker() {
+        auto next = std::chrono::steady_clock::now();
+        while (this->schedulerRunning) {
+            next += std::chrono::milliseconds(TICK_MS);
+            std::this_thread::sleep_until(next);
+            advanceTimers(++g_cpu_tick);
+            sealSnapshot(g_cpu_tick);
+        }
+    }
 
-                for (unsigned int i = 0; i < slice; ++i) {
-                    if (!executeInstruction(*process_to_run)) {
-                        break; 
-                    }
-                    active_cpu_ticks++;
+    // I/O worker for real-time runs: services page_ins in order, then
+    // whole-process swaps, then prefetches. A blocked process stays at the
+    // front of page_ins, visible to getAllProcesses, while its page is read.
+    void pager() {
+        std::unique_lock<std::mutex> lock(this->pagerMutex);
+        auto has_work = [&] {
+            return !this->page_ins.empty() || !this->swap_ins.empty() ||
+                   !this->swap_outs.empty() || !this->prefetches.empty();
+        };
+        while (this->schedulerRunning) {
+            pagerCv.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                return has_work() || !this->schedulerRunning;
+            });
+
+            while (has_work() && this->schedulerRunning) {
+                if (this->page_ins.empty() && (!this->swap_ins.empty() || !this->swap_outs.empty())) {
+                    lock.unlock();
+                    serviceSwaps();
+                    lock.lock();
+                    continue;
                 }
-                
-                process_to_run->setRemainingBurst(
-                    process_to_run->getInstructionCount() - process_to_run->getProgramCounter()
-                );
-
-
-                // Set when the process leaves the CPU for good; its frames are
-                // released after queueMutex is dropped (see below).
-                int finished_pid = -1;
-
-                {
-                    std::lock_guard<std::mutex> lock(this->queueMutex);
-
-
-                    auto it = std::find_if(runningProcesses.begin(), runningProcesses.end(),
-                        [&](const auto& p) { return p.get() == process_to_run; });
-
-                    if (it != runningProcesses.end()) {
-                        if (process_to_run->getRemainingBurst() > 0 && process_to_run->getState() != ProcessState::TERMINATED) {
-                            process_to_run->setState(ProcessState::WAITING);
-                            process_to_run->setCurrentCoreId(-1); // Un-assign core
-                            this->ready_queue.push_back(std::move(*it)); // Re-queue it
-                            this->queueCV.notify_one();
-                        } else {
-                            if (process_to_run->getState() != ProcessState::TERMINATED) {
-                                process_to_run->setState(ProcessState::FINISHED);
-                            }
-                            finished_pid = process_to_run->getPid();
-                            this->completedProcesses.push_back(std::move(*it)); // Move to completed
-                        }
-
-                        runningProcesses.erase(it);
-                    }
+                if (this->page_ins.empty()) {
+                    // Processes are never freed while the scheduler runs, and
+                    // the MMU ignores pages of a process that has finished.
+                    Prefetch prefetch = this->prefetches.front();
+                    this->prefetches.pop_front();
+                    lock.unlock();
+                    mmu->prefetchPage(*prefetch.process, prefetch.page);
+                    lock.lock();
+                    continue;
                 }
 
-                // Outside queueMutex on purpose: releaseProcessMemory takes
-                // mmu_mutex, and handlePageFault takes mmu_mutex then queueMutex.
-                // Holding queueMutex here would invert that order and deadlock.
-                if (finished_pid != -1) {
-                    mmu->releaseProcessMemory(finished_pid);
+                Process& process = *this->page_ins.front();
+                lock.unlock();
+                try {
+                    mmu->handlePageFault(process, process.getBlockedPage(), process.isBlockedOnWrite());
+                    process.pageArrived();
+                } catch (const std::exception& e) {
+                    std::cerr << "[Scheduler] Exception while paging in PID " << process.getPid()
+                              << ": " << e.what() << std::endl;
+                    process.terminate(std::string("Internal error: ") + e.what());
                 }
-            } else {
-               
-                idle_cpu_ticks++;
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            }
-
-            // time slice execution, rr
-            // if (current_process) {
-            //     current_process->setState(ProcessState::RUNNING);
-            //     current_process->setCurrentCoreId(coreId);
-
-            //     unsigned int slice = std::min<unsigned>(
-            //         current_process->getRemainingBurst(),
-            //         this->quantumCycles
-            //     );
-
-            //     for (unsigned int i = 0; i < slice; ++i) {
-            //         if (!executeInstruction(*current_process)) {
-            //             break; 
-            //         }
-            //         active_cpu_ticks++;
-            //     }
-                
-            //     current_process->setRemainingBurst(
-            //         current_process->getInstructionCount() - current_process->getProgramCounter()
-            //     );
-
- 
-            //     if (current_process->getRemainingBurst() > 0) {
-            //         current_process->setState(ProcessState::WAITING);
-            //         {
-            //             std::lock_guard<std::mutex> lock(this->queueMutex);
-            //             this->ready_queue.push_back(std::move(current_process));
-            //             this->queueCV.notify_one(); 
-            //         }
-            //     } else {
-
-            //         current_process->setState(ProcessState::FINISHED);
-            //         {
-            //             std::lock_guard<std::mutex> lock(this->queueMutex);
-            //             this->completedProcesses.push_back(std::move(current_process));
-            //         }
-            //     }
-            // }
+                lock.lock();
+
+                std::unique_ptr<Process> done = std::move(this->page_ins.front());
+                this->page_ins.pop_front();
+                lock.unlock();
+                if (done->getState() == ProcessState::TERMINATED) {
+                    fileCompleted(std::move(done));
+                } else {
+                    enqueue(std::move(done));
+                }
+                lock.lock();
+            }
         }
-        std::cout << "Core " << coreId << ": Exiting Round Robin worker thread." << std::endl;
     }
 
-    bool executeInstruction(Process& process) {
-      // An exception escaping a worker thread calls std::terminate and takes the
-      // whole emulator down, so contain it here and kill only this process.
-      try {
-        size_t pc = process.getProgramCounter();
-        if (pc >= process.getInstructionCount()) {
-            return false;
-        }
-        const auto& command = process.getInstructions()[pc];
+    // Frames a process should need: the pages its next instructions touch
+    // that hold a frame now. Pages never written read as the shared zero
+    // page and take none. Only safe on a process no core is running.
+    size_t estimateWorkingSet(Process& process) {
+        std::vector<int> pages;
+        process.getUpcomingPages(ADMISSION_LOOKAHEAD, pages);
+        PageTable* page_table = process.getPageTable();
+        return std::count_if(pages.begin(), pages.end(),
+                             [&](int page) { return page_table->getFrameNumber(page) >= 0; });
+    }
+
+    // Admitted processes below which admission never holds anyone back:
+    // one per core. Blocked and sleeping processes do not raise it, or it
+    // would climb exactly when memory is thrashing.
+    size_t admissionFloor() const {
+        return std::max<size_t>(1, cores.size());
+    }
 
-        int required_page = -1;
-        if (auto* read_cmd = dynamic_cast<READ*>(command.get())) {
+    // Caller holds queueMutex. Admits suspended processes, front first,
+    // while they fit. One that was swapped out waits for the pager to read
+    // it back before it is queued.
+    void admitSuspended() {
+        admitted_while_thrashing = mmu->isThrashing();
+        if (suspended.empty()) return;
+        size_t frames = mmu->getTotalMemory() / mmu->getPageSize();
+        size_t committed = 0;
+        for (const Admission& a : admitted) {
+            committed += std::max(a.estimate, mmu->getWorkingSet(*a.process));
+        }
 
-            // bounds check run before the page table is consulted
-            // an address past the process's memory maps to a page number
-            // the table does not have, which would throw exceptions and crash
-            // the emulator
-            if (read_cmd->getAddress() >= process.getMemorySize()) {
-                process.terminateWithViolation(read_cmd->getAddress());
-                return false;
+        size_t floor = admissionFloor();
+        while (!suspended.empty()) {
+            Process& next = *suspended.front();
+            size_t need = std::max(estimateWorkingSet(next), mmu->getWorkingSet(next));
+            // Flat mode has no working sets: blocks are placed at dispatch.
+            if (admitted.size() >= floor && !mmu->isFlat() &&
+                (mmu->isThrashing() || committed + need > frames)) break;
+            committed += need;
+            admitted.push_back({&next, need});
+            next.setState(ProcessState::WAITING);
+            if (mmu->hasSwappedPages(next)) {
+                std::lock_guard<std::mutex> pager_lock(pagerMutex);
+                swap_ins.push_back(std::move(suspended.front()));
+                pagerCv.notify_one();
+            } else {
+                enqueue(std::move(suspended.front()));
             }
-            required_page = read_cmd->getRequiredPage(mmu->getPageSize());
+            suspended.pop_front();
+        }
 
-        } else if (auto* write_cmd = dynamic_cast<WRITE*>(command.get())) {
+        for (auto& p : suspended) {
+            if (p->getState() == ProcessState::IDLE) {
+                p->setState(ProcessState::SUSPENDED);
+                admission_deferrals++;
+            }
+        }
+    }
 
-            if (write_cmd->getAddress() >= process.getMemorySize()) {
-                process.terminateWithViolation(write_cmd->getAddress());
-                return false;
+    // Caller holds queueMutex. Gives back process's share of memory and
+    // lets whoever now fits in.
+    void leaveSystem(Process* process) {
+        for (size_t i = 0; i < admitted.size(); ++i) {
+            if (admitted[i].process == process) {
+                admitted.erase(admitted.begin() + i);
+                break;
             }
-            required_page = write_cmd->getRequiredPage(mmu->getPageSize());
+        }
+        admitSuspended();
+    }
 
-        } else {
+    // Files a process that is on no core as completed.
+    void fileCompleted(std::unique_ptr<Process> process) {
+        mmu->releaseProcessMemory(*process);
+        process->flushLogs();
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        Process* done = process.get();
+        this->completedProcesses.push_back(std::move(process));
+        leaveSystem(done);
+    }
 
-            required_page = 0;
+    // Files the core's running process as completed.
+    void retire(int coreId) {
+        CoreQueue& core = *cores[coreId];
+        Process* process = core.running.get();
+        if (process->getState() != ProcessState::TERMINATED) {
+            process->setState(ProcessState::FINISHED);
         }
 
+        // Return this process's frames to the free list before it is filed
+        // away. The MMU never takes scheduler locks (frames map back to their
+        // page tables directly), but releaseProcessMemory may wait for an
+        // in-flight writeback, so it is still kept outside queueMutex.
+        mmu->releaseProcessMemory(*process);
+        // Finished processes are kept for reports; their logs needn't be.
+        process->flushLogs();
+
+        // Not a scoped_lock over both: admitting others locks core queues.
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        {
+            std::lock_guard<std::mutex> core_lock(core.mutex);
+            this->completedProcesses.push_back(std::move(core.running));
+        }
+        leaveSystem(process);
+    }
+
+    // Flat memory mode: a dispatched process needs its whole block before it
+    // runs. If memory is full it goes back to the tail of the queue and the
+    // core waits a tick; one that can never fit is terminated.
+    bool placeInMemory(int coreId, Process& process) {
+        if (!mmu->isFlat()) return true;
+        try {
+            if (mmu->allocateFlat(process)) return true;
+        } catch (const std::length_error& e) {
+            process.terminate(e.what());
+            std::cout << "[Scheduler] Process " << process.getPid() << " terminated due to: "
+                      << process.getTerminationReason() << std::endl;
+            retire(coreId);
+            return false;
+        }
+
+        preempt(coreId);
+        idle_cpu_ticks++;
+        if (!g_virtual_time) std::this_thread::sleep_for(std::chrono::milliseconds(TICK_MS));
+        return false;
+    }
+
+    // Runs a dispatched process to completion, or until it sleeps. Returns
+    // the CPU ticks it used, counting delays-perexec.
+    uint64_t runFcfs(int coreId, Process& process) {
+        if (!placeInMemory(coreId, process)) return 0;
+        process.setState(ProcessState::RUNNING);
+        prefetchUpcoming(process);
+
+        unsigned int executed = runInstructions(process,
+            process.getInstructionCount() - process.getProgramCounter());
+        uint64_t ticks = (uint64_t)executed * (1 + this->delays_perexec);
+
+        if (process.getState() == ProcessState::SLEEPING) {
+            park(coreId);
+        } else if (process.getState() == ProcessState::BLOCKED) {
+            blockForPage(coreId);
+        } else {
+            retire(coreId);
+        }
+        return ticks;
+    }
+
+    // Runs one quantum of a dispatched process, then requeues, parks or
+    // retires it. Returns the CPU ticks it used, counting delays-perexec.
+    uint64_t runRoundRobin(int coreId, Process& process) {
+        if (!placeInMemory(coreId, process)) return 0;
+        process.setState(ProcessState::RUNNING);
+        prefetchUpcoming(process);
+
+        unsigned int slice = std::min<unsigned>(
+            process.getRemainingBurst(),
+            (unsigned int)this->quantumCycles
+        );
+
+        unsigned int executed = runInstructions(process, slice);
+        uint64_t ticks = (uint64_t)executed * (1 + this->delays_perexec);
+
+        process.setRemainingBurst(
+            process.getInstructionCount() - process.getProgramCounter()
+        );
+
+        if (process.getState() == ProcessState::SLEEPING) {
+            park(coreId);
+        } else if (process.getState() == ProcessState::BLOCKED) {
+            blockForPage(coreId);
+        } else if (process.getRemainingBurst() > 0 && process.getState() != ProcessState::TERMINATED) {
+            preempt(coreId);
+        } else {
+            retire(coreId);
+        }
+        return ticks;
+    }
 
-        while (!process.getPageTable()->isPresent(required_page)) {
-            mmu->handlePageFault(process, required_page);
+    uint64_t runDispatched(int coreId, Process& process) {
+        if (this->SchedulerType == "fcfs") {
+            return runFcfs(coreId, process);
         }
+        return runRoundRobin(coreId, process);
+    }
 
+    void fcfs_scheduler(int coreId) {
+        while (this->schedulerRunning) {
+            Process* current_process = dispatch(coreId);
+            if (!current_process) {
+                idle_cpu_ticks++;
+                continue;
+            }
+            runFcfs(coreId, *current_process);
+        }
+        std::cout << "Core " << coreId << ": Exiting FCFS worker thread." << std::endl;
+    }
 
-        process.runInstructionSlice(1); 
+    void rr_scheduler(int coreId){
+        while (this->schedulerRunning) {
+            Process* process_to_run = dispatch(coreId);
+            if (!process_to_run) {
+                idle_cpu_ticks++;
+                continue;
+            }
+            runRoundRobin(coreId, *process_to_run);
+        }
+        std::cout << "Core " << coreId << ": Exiting Round Robin worker thread." << std::endl;
+    }
 
-        if (this->delays_perexec > 0) {
+    // Runs up to budget instructions of a dispatched process. Stops early if
+    // the process sleeps, terminates or faults; a fault normally leaves it
+    // BLOCKED on the missing page. Returns how many instructions completed.
+    unsigned int runInstructions(Process& process, unsigned int budget) {
+      unsigned int executed = 0;
+      // An exception escaping a worker thread calls std::terminate and takes the
+      // whole emulator down, so contain it here and kill only this process.
+      try {
+        // delays-perexec sleeps between instructions, so hand them out one at
+        // a time; otherwise the whole budget runs in one call.
+        bool per_instruction = this->delays_perexec > 0 && !g_virtual_time;
+
+        while (executed < budget && process.getState() == ProcessState::RUNNING &&
+               process.getProgramCounter() < (size_t)process.getInstructionCount()) {
+            SliceResult slice = process.runInstructionSlice(per_instruction ? 1 : budget - executed);
+            executed += slice.retired;
+            mmu->recordPageHits(slice.page_hits);
+
+            if (slice.retired > 0) process.setResumedFromFault(false);
+
+            if (slice.fault_page >= 0) {
+                // Faulting again before any progress means its last page-in
+                // was stolen or it needs several pages at once. Fetch inline
+                // so it cannot be starved under heavy memory pressure.
+                if (process.isResumedFromFault()) {
+                    mmu->handlePageFault(process, slice.fault_page, slice.fault_write);
+                    continue;
+                }
+                process.blockOnPage(slice.fault_page, slice.fault_write);
+                break;
+            }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(this->delays_perexec));
+            if (per_instruction) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(this->delays_perexec));
+            }
         }
 
         if (process.getState() == ProcessState::TERMINATED) {
             std::cout << "[Scheduler] Process " << process.getPid() << " terminated due to: " 
                       << process.getTerminationReason() << std::endl;
-            return false;
         }
-
-        return true;
       } catch (const std::exception& e) {
         std::cerr << "[Scheduler] Exception while executing PID " << process.getPid()
                   << ": " << e.what() << std::endl;
         process.terminate(std::string("Internal error: ") + e.what());
-        return false;
       }
+      active_cpu_ticks += executed;
+      return executed;
     }
 
     std::string get_timestamp() {
@@ -303,17 +734,9 @@ class Scheduler {
         : SchedulerType(type), quantumCycles(quantum), mmu(mem_manager), delays_perexec(delay) {}
 
      Process* findProcessByName(const std::string& name) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        
-        for (const auto& p : processes) { if (p->getProcessName() == name) return p.get(); }
-        for (const auto& p : runningProcesses) { if (p->getProcessName() == name) return p.get(); }
-        for (const auto& p : completedProcesses) { if (p->getProcessName() == name) return p.get(); }
-        
-
-        for (const auto& p : ready_queue) {
-            if (p->getProcessName() == name) return p.get();
+        for (Process* p : getAllProcesses()) {
+            if (p->getProcessName() == name) return p;
         }
-
         return nullptr; 
     }
 
@@ -322,25 +745,55 @@ class Scheduler {
         std::lock_guard<std::mutex> lock(queueMutex);
 
         for(const auto& p : processes) { all_procs.push_back(p.get()); }
-        for(const auto& p : runningProcesses) { all_procs.push_back(p.get()); }
-        for(const auto& p : completedProcesses) { all_procs.push_back(p.get()); }
-        
-        for(const auto& p : ready_queue) {
-            all_procs.push_back(p.get());
+        for(const auto& p : suspended) { all_procs.push_back(p.get()); }
+        for(Process* p : forking) { all_procs.push_back(p); }
+        for(const auto& core : cores) {
+            std::lock_guard<std::mutex> core_lock(core->mutex);
+            if (core->running) { all_procs.push_back(core->running.get()); }
+            for(const auto& p : core->ready) { all_procs.push_back(p.get()); }
+        }
+        {
+            std::lock_guard<std::mutex> sleep_lock(sleepMutex);
+            sleepers.forEach([&](const std::unique_ptr<Process>& p) { all_procs.push_back(p.get()); });
         }
+        {
+            std::lock_guard<std::mutex> pager_lock(pagerMutex);
+            for(const auto& p : page_ins) { all_procs.push_back(p.get()); }
+            for(const auto& p : swap_ins) { all_procs.push_back(p.get()); }
+            for(const auto& p : swap_outs) { all_procs.push_back(p.get()); }
+        }
+        for(const auto& p : completedProcesses) { all_procs.push_back(p.get()); }
         
         return all_procs;
     }
 
 
-    void checkIfComplete() {
+    // True once every process created so far has finished: none is waiting,
+    // queued, parked, being forked or on a core.
+    bool isDrained() {
         std::lock_guard<std::mutex> lock(queueMutex);
-        // running threads done? 
-        if (!generatingProcesses && ready_queue.empty() ) {
-            schedulerRunning = false;
-            queueCV.notify_all();
-            std::cout << "All processes completed. Scheduler is shutting down.\n";
+        if (!processes.empty() || !suspended.empty() || !forking.empty()) return false;
+        {
+            std::lock_guard<std::mutex> sleep_lock(sleepMutex);
+            if (!sleepers.empty()) return false;
         }
+        {
+            std::lock_guard<std::mutex> pager_lock(pagerMutex);
+            if (!page_ins.empty() || !swap_ins.empty() || !swap_outs.empty()) return false;
+        }
+        for (const auto& core : cores) {
+            std::lock_guard<std::mutex> core_lock(core->mutex);
+            if (core->running || !core->ready.empty()) return false;
+        }
+        return true;
+    }
+
+    void checkIfComplete() {
+        // running threads done? 
+        if (generatingProcesses || !isDrained()) return;
+        schedulerRunning = false;
+        notifyAllCores();
+        std::cout << "All processes completed. Scheduler is shutting down.\n";
     }
     
     void addProcess(std::unique_ptr<Process> process) {
@@ -349,13 +802,112 @@ class Scheduler {
         processes.push_back(std::move(process));
     }
 
-    // Used by the MMU to find the owner of a frame it is about to evict.
     Process* findProcessByPid(int pid) {
         std::lock_guard<std::mutex> lock(queueMutex);
         auto it = process_registry.find(pid);
         return (it == process_registry.end()) ? nullptr : it->second;
     }
 
+    // Forks parent while it waits in a queue. It is taken out under that
+    // queue's lock and copied with no scheduler lock held, since copying
+    // its address space may write pages out, then put back. Returns nullptr
+    // if it is on a core, or being paged or swapped, right now; the caller
+    // may try again.
+    std::unique_ptr<Process> forkParked(Process* parent, int child_pid, const std::string& child_name) {
+        enum class From { Created, Suspended, Ready, Sleeping, PageIn, SwapIn, SwapOut };
+        From from = From::Created;
+        std::unique_ptr<Process> parked;
+        uint64_t wake_tick = 0;
+        auto take = [&](auto& container, size_t first) {
+            for (size_t i = first; i < container.size(); ++i) {
+                if (container[i].get() == parent) {
+                    parked = std::move(container[i]);
+                    container.erase(container.begin() + i);
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (take(processes, 0)) {
+                from = From::Created;
+            } else if (take(suspended, 0)) {
+                from = From::Suspended;
+            }
+            for (size_t i = 0; i < cores.size() && !parked; ++i) {
+                std::lock_guard<std::mutex> core_lock(cores[i]->mutex);
+                if (take(cores[i]->ready, 0)) {
+                    cores[i]->depth = cores[i]->ready.size();
+                    from = From::Ready;
+                }
+            }
+            if (!parked) {
+                std::lock_guard<std::mutex> sleep_lock(sleepMutex);
+                auto is_parent = [&](const std::unique_ptr<Process>& p) { return p.get() == parent; };
+                if (sleepers.remove(is_parent, parked, wake_tick)) from = From::Sleeping;
+            }
+            if (!parked) {
+                // The pager is working on the front of each of its queues.
+                std::lock_guard<std::mutex> pager_lock(pagerMutex);
+                if (take(page_ins, 1)) {
+                    from = From::PageIn;
+                } else if (take(swap_ins, 1)) {
+                    from = From::SwapIn;
+                } else if (take(swap_outs, 1)) {
+                    from = From::SwapOut;
+                }
+            }
+            if (!parked) return nullptr;
+            forking.push_back(parent);
+        }
+
+        std::unique_ptr<Process> child;
+        std::exception_ptr error;
+        try {
+            child = parent->fork(child_pid, child_name);
+            mmu->forkAddressSpace(*parent, *child);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            forking.erase(std::find(forking.begin(), forking.end(), parent));
+            switch (from) {
+            case From::Created:
+                processes.push_back(std::move(parked));
+                break;
+            case From::Suspended:
+                suspended.push_front(std::move(parked));
+                break;
+            case From::Ready:
+                enqueue(std::move(parked));
+                break;
+            case From::Sleeping: {
+                std::lock_guard<std::mutex> sleep_lock(sleepMutex);
+                sleepers.schedule(wake_tick, std::move(parked));
+                break;
+            }
+            default: {
+                std::lock_guard<std::mutex> pager_lock(pagerMutex);
+                if (from == From::PageIn) {
+                    page_ins.push_back(std::move(parked));
+                } else if (from == From::SwapIn) {
+                    swap_ins.push_back(std::move(parked));
+                } else {
+                    swap_outs.push_back(std::move(parked));
+                }
+                pagerCv.notify_one();
+                break;
+            }
+            }
+        }
+        if (error) std::rethrow_exception(error);
+        return child;
+    }
+
     void schedulerAlgo(int coreId) {
         if (this->SchedulerType == "fcfs") {
             fcfs_scheduler(coreId);
@@ -366,16 +918,15 @@ class Scheduler {
         }
     }
 
+    // Puts every IDLE process behind those already suspended, then admits
+    // as many as fit onto the least loaded cores' run queues.
     void queueProcesses() {
         std::lock_guard<std::mutex> lock(queueMutex);
+        if (cores.empty()) return;
 
         auto is_idle = [&](std::unique_ptr<Process>& p) {
             if (p && p->getState() == ProcessState::IDLE) {
-                p->setState(ProcessState::WAITING);
-
-                ready_queue.push_back(std::move(p)); 
-                queueCV.notify_one();
-
+                suspended.push_back(std::move(p));
                 return true; 
             }
             return false;
@@ -383,29 +934,150 @@ class Scheduler {
 
         auto new_end = std::remove_if(processes.begin(), processes.end(), is_idle);
         processes.erase(new_end, processes.end());
+        admitSuspended();
+    }
+
+    void createCores(int num_cpu) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (cores.empty()) {
+            for (int coreId = 0; coreId < num_cpu; ++coreId) {
+                cores.push_back(std::make_unique<CoreQueue>());
+            }
+        }
     }
 
     void startScheduler(int num_cpu) {
+        createCores(num_cpu);
+
         this->schedulerRunning = true;
          for (int coreId = 0; coreId < num_cpu; ++coreId) {
             workerThreads.emplace_back(&Scheduler::schedulerAlgo, this, coreId);
         }
+        tickerThread = std::thread(&Scheduler::ticker, this);
+        pagerThread = std::thread(&Scheduler::pager, this);
 
     }
 
+    // Turbo mode: a single-threaded discrete-event run of the same dispatch,
+    // slice and retire paths the worker threads use, against the virtual
+    // clock g_cpu_tick. Each core is an event that fires when its last
+    // quantum would have ended; the generator is an event every batch_period
+    // ticks, each sleeper adds one at its wake-up tick and each page fault
+    // one when its page-in completes. generate_batch
+    // creates one batch and returns false once it has produced its last one.
+    // Returns when every process has left the system.
+    void runVirtual(int num_cpu, uint64_t batch_period, const std::function<bool()>& generate_batch) {
+        const int GENERATOR_EVENT = -1;
+        const int TIMER_EVENT = -2;
+
+        struct SimEvent {
+            uint64_t tick;
+            uint64_t seq;       // FIFO among same-tick events, keeps runs reproducible
+            int core;           // or GENERATOR_EVENT / TIMER_EVENT
+        };
+        auto later = [](const SimEvent& a, const SimEvent& b) {
+            return a.tick != b.tick ? a.tick > b.tick : a.seq > b.seq;
+        };
+        std::priority_queue<SimEvent, std::vector<SimEvent>, decltype(later)> events(later);
+        uint64_t seq = 0;
+
+        createCores(num_cpu);
+        std::vector<bool> core_idle(num_cpu, true);
+        std::vector<uint64_t> idle_since(num_cpu, 0);
+
+        auto wake_idle_cores = [&](uint64_t now) {
+            for (int c = 0; c < num_cpu; ++c) {
+                if (core_idle[c]) {
+                    core_idle[c] = false;
+                    idle_cpu_ticks += now - idle_since[c];
+                    events.push({now, seq++, c});
+                }
+            }
+        };
+
+        auto work_queued = [&]() {
+            for (const auto& core : cores) {
+                if (core->depth > 0) return true;
+            }
+            return false;
+        };
+
+        events.push({0, seq++, GENERATOR_EVENT});
+        uint64_t now = 0;
+        uint64_t quantum_ticks = (uint64_t)std::max(1, this->quantumCycles);
+
+        while (!events.empty()) {
+            SimEvent ev = events.top();
+            events.pop();
+            if (ev.tick / quantum_ticks > now / quantum_ticks) {
+                // Closes the quantum the last event ran in, labelled as the
+                // ticker would at its end; quanta skipped over had no changes.
+                sealSnapshot((now / quantum_ticks + 1) * quantum_ticks);
+            }
+            now = ev.tick;
+            g_cpu_tick = now;
+            advanceTimers(now);
+
+            if (ev.core == GENERATOR_EVENT) {
+                if (generate_batch()) {
+                    events.push({now + batch_period, seq++, GENERATOR_EVENT});
+                }
+                queueProcesses();
+            } else if (ev.core >= 0) {
+                Process* process = takeNext(ev.core);
+                if (!process) {
+                    core_idle[ev.core] = true;
+                    idle_since[ev.core] = now;
+                    continue;
+                }
+
+                uint64_t ticks = runDispatched(ev.core, *process);
+                events.push({now + std::max<uint64_t>(ticks, 1), seq++, ev.core});
+
+                if (process->getState() == ProcessState::SLEEPING) {
+                    events.push({process->getWakeTick(), seq++, TIMER_EVENT});
+                } else if (process->getState() == ProcessState::BLOCKED) {
+                    events.push({now + PAGE_IN_TICKS, seq++, TIMER_EVENT});
+                }
+            }
+
+            // There is no pager thread here; swaps queued by this event are
+            // done before anything else runs. An idle core queues none.
+            serviceSwaps();
+
+            // New arrivals, wake-ups and requeues can all be picked up or
+            // stolen by a core that went idle.
+            if (work_queued()) {
+                wake_idle_cores(now);
+            }
+        }
+
+        for (int c = 0; c < num_cpu; ++c) {
+            if (core_idle[c]) idle_cpu_ticks += now - idle_since[c];
+        }
+        sealSnapshot((now / quantum_ticks + 1) * quantum_ticks);
+    }
+
+    void notifyAllCores() {
+        for (auto& core : cores) core->cv.notify_all();
+    }
+
     void stopGenerating() {
         generatingProcesses = false;
-        queueCV.notify_all();   
+        notifyAllCores();
     }
 
 
     void stopScheduler() {
         schedulerRunning = false;
         generatingProcesses = false;
-        queueCV.notify_all();
+        notifyAllCores();
         for (auto &t : workerThreads)
             if (t.joinable()) t.join();
         workerThreads.clear();
+        if (tickerThread.joinable()) tickerThread.join();
+        pagerCv.notify_all();
+        if (pagerThread.joinable()) pagerThread.join();
     }
 
     void finalizeScheduler() {
@@ -414,6 +1086,9 @@ class Scheduler {
                 if (t.joinable())
                     t.join();
             }
+            if (tickerThread.joinable()) tickerThread.join();
+        pagerCv.notify_all();
+        if (pagerThread.joinable()) pagerThread.join();
             std::cout << "Scheduler fully shut down. All processes completed.\n";
     }
 
@@ -426,6 +1101,15 @@ class Scheduler {
         return generatingProcesses;
     }
 
+    size_t getNumSuspended() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return suspended.size();
+    }
+
+    size_t getNumAdmissionDeferrals() const {
+        return admission_deferrals.load();
+    }
+
     size_t getActiveTicks() const {
         return active_cpu_ticks.load();
     }
@@ -439,13 +1123,16 @@ class Scheduler {
     }
 
     float computeUtilization(int num_cpu) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return (100.0f * runningProcesses.size()) / num_cpu;
+        return (100.0f * numBusyCores()) / num_cpu;
     }
 
     int numBusyCores() {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return (int)runningProcesses.size();
+        int busy = 0;
+        for (const auto& core : cores) {
+            std::lock_guard<std::mutex> lock(core->mutex);
+            if (core->running) busy++;
+        }
+        return busy;
     }
 
 
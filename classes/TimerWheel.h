@@ -0,0 +1,125 @@
+// TimerWheel.h
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Hierarchical timing wheel keyed by absolute tick. Level 0 has one slot per
+// tick; each higher level's slot spans a full turn of the level below and is
+// cascaded down when that level wraps. Deadlines past the top level wait in
+// an overflow list. schedule() is O(1) and advance() is O(1) per tick plus
+// the entries it moves.
+template <typename T>
+class TimerWheel {
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 3;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Entry {
+        uint64_t deadline;
+        T item;
+    };
+
+    std::vector<Entry> wheel[LEVELS][SLOTS];
+    std::vector<Entry> overflow;
+    uint64_t current_tick = 0;
+    size_t count = 0;
+
+    void place(Entry&& entry) {
+        uint64_t delta = entry.deadline - current_tick;
+        for (int level = 0; level < LEVELS; ++level) {
+            if (delta < (1ULL << (SLOT_BITS * (level + 1)))) {
+                size_t slot = (entry.deadline >> (SLOT_BITS * level)) & SLOT_MASK;
+                wheel[level][slot].push_back(std::move(entry));
+                return;
+            }
+        }
+        overflow.push_back(std::move(entry));
+    }
+
+    // Re-files every entry of one slot relative to the current tick.
+    void cascade(std::vector<Entry>& slot) {
+        std::vector<Entry> moving;
+        moving.swap(slot);
+        for (auto& entry : moving) {
+            place(std::move(entry));
+        }
+    }
+
+public:
+    // Files item to fire at deadline. Deadlines not in the future fire on
+    // the next tick.
+    void schedule(uint64_t deadline, T item) {
+        if (deadline <= current_tick) deadline = current_tick + 1;
+        place(Entry{deadline, std::move(item)});
+        count++;
+    }
+
+    // Steps the wheel forward to tick, appending every item whose deadline
+    // has passed to expired in deadline order.
+    void advance(uint64_t tick, std::vector<T>& expired) {
+        while (current_tick < tick) {
+            current_tick++;
+
+            if ((current_tick & SLOT_MASK) == 0) {
+                // Cascade from the top so entries fall through every level.
+                if ((current_tick & ((1ULL << (SLOT_BITS * LEVELS)) - 1)) == 0) {
+                    cascade(overflow);
+                }
+                for (int level = LEVELS - 1; level >= 1; --level) {
+                    if ((current_tick & ((1ULL << (SLOT_BITS * level)) - 1)) == 0) {
+                        cascade(wheel[level][(current_tick >> (SLOT_BITS * level)) & SLOT_MASK]);
+                    }
+                }
+            }
+
+            std::vector<Entry>& due = wheel[0][current_tick & SLOT_MASK];
+            for (auto& entry : due) {
+                expired.push_back(std::move(entry.item));
+            }
+            count -= due.size();
+            due.clear();
+        }
+    }
+
+    // Takes out the first item pred accepts, and its deadline. Walks every
+    // slot, so it is only for rare lookups. Returns false if none matches.
+    template <typename Pred>
+    bool remove(Pred&& pred, T& item, uint64_t& deadline) {
+        auto take = [&](std::vector<Entry>& slot) {
+            for (size_t i = 0; i < slot.size(); ++i) {
+                if (!pred(slot[i].item)) continue;
+                item = std::move(slot[i].item);
+                deadline = slot[i].deadline;
+                slot.erase(slot.begin() + i);
+                count--;
+                return true;
+            }
+            return false;
+        };
+        for (int level = 0; level < LEVELS; ++level) {
+            for (int slot = 0; slot < SLOTS; ++slot) {
+                if (take(wheel[level][slot])) return true;
+            }
+        }
+        return take(overflow);
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (int level = 0; level < LEVELS; ++level) {
+            for (int slot = 0; slot < SLOTS; ++slot) {
+                for (const auto& entry : wheel[level][slot]) fn(entry.item);
+            }
+        }
+        for (const auto& entry : overflow) fn(entry.item);
+    }
+
+    uint64_t now() const { return current_tick; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
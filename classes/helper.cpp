@@ -3,15 +3,30 @@
 #include <cstdlib> // for system()
 #include <ctime>
 #include <vector>
+#include <atomic>
+#include <cstdint>
 
-std::string get_timestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
+// Length of one emulated CPU tick in real time (SLEEP 1 sleeps this long).
+const int TICK_MS = 10;
+
+// Emulated CPU clock. In turbo mode (g_virtual_time) this is the only notion
+// of time: nothing really sleeps and timestamps are printed as ticks.
+std::atomic<uint64_t> g_cpu_tick{0};
+std::atomic<bool> g_virtual_time{false};
+
+std::string format_timestamp(std::time_t when) {
     char buffer[100];
-    std::strftime(buffer, sizeof(buffer), "%m/%d/%Y, %I:%M:%S %p", std::localtime(&now_time));
+    std::strftime(buffer, sizeof(buffer), "%m/%d/%Y, %I:%M:%S %p", std::localtime(&when));
     return std::string(buffer);
 }
 
+std::string get_timestamp() {
+    if (g_virtual_time) {
+        return "Tick " + std::to_string(g_cpu_tick.load());
+    }
+    return format_timestamp(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+}
+
 void clear_screen() {
     #ifdef _WIN32
         std::system("cls");
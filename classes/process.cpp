@@ -1,33 +1,40 @@
 // classes/Process.cpp
 #include "process.h"
 #include "ICommand.cpp"
+#include "LogArchive.cpp"
+#include "MemoryManager.h"
 #include <iostream>
+#include <algorithm>
+
+extern LogArchive* g_log_archive;
+extern MemoryManager* g_memory_manager;
+
+const size_t LOG_PAGE_SIZE = 20;    // entries per page in runScreenInterface
 
 std::string processStateToString(ProcessState state) {
     switch (state) {
         case ProcessState::IDLE: return "IDLE";
         case ProcessState::WAITING: return "WAITING";
         case ProcessState::RUNNING: return "RUNNING";
+        case ProcessState::SLEEPING: return "SLEEPING";
         case ProcessState::FINISHED: return "FINISHED";
+        case ProcessState::BLOCKED: return "BLOCKED";
+        case ProcessState::SUSPENDED: return "SUSPENDED";
         default: return "UNKNOWN";
     }
 }
 
-Process::Process(int id, const std::string& name, size_t mem_size, size_t page_size) 
+Process::Process(int id, const std::string& name, size_t mem_size, size_t page_size, int page_table_levels) 
     : pid(id), 
       process_name(name), 
       current_core_id(-1), 
       state(ProcessState::IDLE),  
       program_counter(0),
       memory_size(mem_size)  {
-            this->page_table = std::make_unique<PageTable>(mem_size, page_size);
+            this->page_table = std::make_unique<PageTable>(mem_size, page_size, page_table_levels);
 
             // Initialize other members as before
 
-            if (mem_size > 0) {
-                memory_space.resize(mem_size / 2, 0); 
-            }
-
             arrival_time = 0;
             burst_time = 0;
             remaining_burst = 0;
@@ -97,28 +104,122 @@ ProcessState Process::getState() const {
 }
 
 std::vector<std::string> Process::getLogs() const {
-    return logs;
+    return getLogs(0, getLogCount());
 }
 
-uint16_t Process::getVariableValue(const std::string& name) const { // Made const correct
+// Entries first..first+count-1 of the full history, reading the archived
+// part back from disk as needed.
+std::vector<std::string> Process::getLogs(uint64_t first, size_t count) const {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::vector<std::string> rendered;
+    uint64_t total = log_archived + log_buffered;
+    if (first >= total) return rendered;
+    count = (size_t)std::min<uint64_t>(count, total - first);
+    rendered.reserve(count);
+
+    if (first < log_archived && g_log_archive) {
+        size_t from_disk = (size_t)std::min<uint64_t>(count, log_archived - first);
+        for (const auto& record : g_log_archive->read(pid, first, from_disk)) {
+            rendered.push_back(renderLog(record));
+        }
+    }
+    for (uint64_t i = std::max(first, log_archived); i < first + count; ++i) {
+        size_t slot = log_head + (size_t)(i - log_archived);
+        if (slot >= log_ring.size()) slot -= log_ring.size();
+        rendered.push_back(renderLog(log_ring[slot]));
+    }
+    return rendered;
+}
 
-    for (size_t i = 0; i < symbol_count; ++i) {
-        if (symbol_table[i].in_use && symbol_table[i].name == name) {
-            return symbol_table[i].value;
+uint64_t Process::getLogCount() const {
+    std::lock_guard<std::mutex> lock(logMutex);
+    return log_archived + log_buffered;
+}
+
+void Process::flushLogs() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (!g_log_archive) return;
+    spillLogs(log_buffered);
+    std::vector<LogRecord>().swap(log_ring);
+    log_head = 0;
+}
+
+// Caller holds logMutex. Writes the count oldest buffered records to the
+// archive, in at most two runs since the ring may wrap, and the text of
+// the notes among them.
+void Process::spillLogs(size_t count) {
+    while (count > 0) {
+        size_t run = std::min(count, log_ring.size() - log_head);
+        g_log_archive->spill(pid, log_archived, &log_ring[log_head], run);
+        for (size_t i = log_head; i < log_head + run; ++i) {
+            if (log_ring[i].kind != LogKind::NOTE) continue;
+            while (log_notes_archived <= log_ring[i].ip && !log_notes.empty()) {
+                g_log_archive->spillNote(pid, log_notes.front());
+                log_notes.pop_front();
+                log_notes_archived++;
+            }
         }
+        log_archived += run;
+        log_buffered -= run;
+        count -= run;
+        log_head += run;
+        if (log_head == log_ring.size()) log_head = 0;
     }
+}
 
-    return 0;
+// Caller holds logMutex.
+void Process::appendLog(const LogRecord& record) {
+    if (!g_log_archive) {
+        // Nothing to spill to; keep everything.
+        log_ring.push_back(record);
+        log_buffered++;
+        return;
+    }
+
+    size_t capacity = g_log_archive->getRingCapacity();
+    if (log_ring.size() != capacity) {
+        log_ring.resize(capacity);
+        log_head = 0;
+    }
+    if (log_buffered == capacity) {
+        // Spill half at once so the file sees few, large appends.
+        spillLogs(std::max<size_t>(capacity / 2, 1));
+    }
+
+    size_t slot = log_head + log_buffered;
+    if (slot >= capacity) slot -= capacity;
+    log_ring[slot] = record;
+    log_buffered++;
+}
+
+// Name-based lookups are for display; running code uses slots directly.
+int Process::findSymbol(const std::string& name) const {
+    for (size_t i = 0; i < bytecode.names.size(); ++i) {
+        if (bytecode.names[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+uint16_t Process::getVariableValue(const std::string& name) const { // Made const correct
+    int slot = findSymbol(name);
+    return (slot < 0) ? 0 : symbol_values[slot];
+}
+
+std::unordered_map<std::string, uint16_t> Process::getVariables() const {
+    std::unordered_map<std::string, uint16_t> variables;
+    for (uint16_t slot : symbol_order) {
+        variables[bytecode.names[slot]] = symbol_values[slot];
+    }
+    return variables;
 }
 
 bool Process::getVariable(const std::string& name, uint16_t& value) const {
-    for (size_t i = 0; i < symbol_count; ++i) {
-        if (symbol_table[i].in_use && symbol_table[i].name == name) {
-            value = symbol_table[i].value;
-            return true; 
-        }
+    int slot = findSymbol(name);
+    if (slot < 0 || !symbol_declared[slot]) {
+        return false; 
     }
-    return false; 
+    value = symbol_values[slot];
+    return true; 
 }
 
 size_t Process::getProgramCounter() const {
@@ -169,25 +270,70 @@ void Process::setState(ProcessState newState) {
     // }
 }
 
+// Takes the process off the CPU until g_cpu_tick reaches tick; the
+// scheduler parks it on its timer wheel.
+void Process::sleepUntil(uint64_t tick) {
+    this->state = ProcessState::SLEEPING;
+    this->wake_tick = tick;
+}
+
+void Process::wakeUp() {
+    this->state = ProcessState::WAITING;
+    this->woke_from_sleep = true;
+}
+
+uint64_t Process::getWakeTick() const {
+    return wake_tick;
+}
+
+void Process::blockOnPage(int page, bool write) {
+    this->state = ProcessState::BLOCKED;
+    this->blocked_page = page;
+    this->blocked_write = write;
+}
+
+void Process::pageArrived() {
+    this->state = ProcessState::WAITING;
+    this->blocked_page = -1;
+    this->resumed_from_fault = true;
+}
+
+int Process::getBlockedPage() const {
+    return blocked_page;
+}
+
+bool Process::isBlockedOnWrite() const {
+    return blocked_write;
+}
+
+bool Process::isResumedFromFault() const {
+    return resumed_from_fault;
+}
+
+void Process::setResumedFromFault(bool resumed) {
+    resumed_from_fault = resumed;
+}
+
 bool Process::setVariable(const std::string& name, uint16_t value) {
-    for (size_t i = 0; i < symbol_count; ++i) {
-        if (symbol_table[i].in_use && symbol_table[i].name == name) {
-            symbol_table[i].value = value;
-            return true; 
-        }
-    }
+    return setSymbol(bytecode.internName(name), value);
+}
 
-    if (symbol_count >= 32) {
-        addLog("[System] Symbol table full. Declaration of '" + name + "' ignored.");
-        return false;
+bool Process::setSymbol(uint16_t slot, uint16_t value) {
+    if (slot >= symbol_values.size()) {
+        symbol_values.resize(bytecode.names.size(), 0);
+        symbol_declared.resize(bytecode.names.size(), false);
     }
 
+    if (!symbol_declared[slot]) {
+        if (symbol_order.size() >= MAX_SYMBOLS) {
+            addLog("[System] Symbol table full. Declaration of '" + bytecode.names[slot] + "' ignored.");
+            return false;
+        }
+        symbol_declared[slot] = true;
+        symbol_order.push_back(slot);
+    }
 
-    symbol_table[symbol_count].name = name;
-    symbol_table[symbol_count].value = value;
-    symbol_table[symbol_count].in_use = true;
-    symbol_count++; 
-    
+    symbol_values[slot] = value;
     return true; 
 }
 
@@ -200,40 +346,263 @@ std::string Process::formatTime(const std::chrono::time_point<std::chrono::syste
 }
 
 void Process::addInstruction(std::unique_ptr<ICommand> instruction) {
+    instruction->compile(bytecode);
+    bytecode.endLine();
     instructions.push_back(std::move(instruction));
+
+    // New names from this instruction get their (undeclared) slots now so
+    // the interpreter never has to bounds-check.
+    symbol_values.resize(bytecode.names.size(), 0);
+    symbol_declared.resize(bytecode.names.size(), false);
+}
+
+std::unique_ptr<Process> Process::fork(int child_pid, const std::string& child_name) const {
+    auto child = std::make_unique<Process>(child_pid, child_name, memory_size, page_table->getPageSize(),
+                                          page_table->getLevels());
+    for (const auto& instruction : instructions) {
+        child->addInstruction(instruction->clone());
+    }
+
+    child->ip = ip;
+    child->loop_stack = loop_stack;
+    child->program_counter = program_counter;
+    child->burst_time = burst_time;
+    child->remaining_burst = instructions.size() - program_counter;
+    child->symbol_values = symbol_values;
+    child->symbol_declared = symbol_declared;
+    child->symbol_order = symbol_order;
+    child->addLog("[System] Forked from " + process_name + " at instruction " + std::to_string(program_counter) + ".");
+    return child;
+}
+
+// Hot path: records what the op at ip did, nothing is formatted here.
+void Process::logOp(LogKind kind, uint16_t operand1, uint16_t operand2, uint16_t result) {
+    LogRecord record;
+    record.tick = g_cpu_tick;
+    record.wall_time = g_virtual_time ? 0 : (int64_t)std::time(nullptr);
+    record.ip = (uint32_t)ip;
+    record.core_id = (int16_t)current_core_id;
+    record.kind = kind;
+    record.op = (ip < bytecode.code.size()) ? bytecode.code[ip].op : OpCode::UNKNOWN;
+    record.operand1 = operand1;
+    record.operand2 = operand2;
+    record.result = result;
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    appendLog(record);
 }
 
-void Process::runInstructionSlice(unsigned int slice_size) {
-    if (state != ProcessState::RUNNING) return;
+std::string Process::renderLog(const LogRecord& record) const {
+    if (record.kind == LogKind::NOTE) {
+        if (record.ip < log_notes_archived) {
+            return g_log_archive ? g_log_archive->readNote(pid, record.ip) : "";
+        }
+        return log_notes[record.ip - log_notes_archived];
+    }
+
+    std::string line = "[Process " + process_name + "] " +
+        (record.wall_time != 0 ? format_timestamp((std::time_t)record.wall_time)
+                               : "Tick " + std::to_string(record.tick)) +
+        " Core ID: " + std::to_string(record.core_id) + ", ";
 
-    for (unsigned int i = 0; i < slice_size && program_counter < instructions.size(); ++i) {
-        instructions[program_counter]->execute(*this);
-        program_counter++; 
+    if (record.kind == LogKind::WOKE_UP) {
+        return line + "Woke up from sleep";
+    }
+    if (record.kind == LogKind::LOOP_DONE) {
+        return line + "FOR loop completed";
+    }
+
+    const Instr& instr = bytecode.code[record.ip];
+    switch (record.op) {
+        case OpCode::PRINT_HELLO:
+            return line + "Hello world from " + process_name;
+        case OpCode::PRINT_MESSAGE:
+            return line + bytecode.strings[instr.arg];
+        case OpCode::PRINT_VAR:
+            return line + bytecode.names[instr.a] + " = " + std::to_string(record.result);
+        case OpCode::PRINT_COMBINED:
+            return line + bytecode.strings[instr.arg] + std::to_string(record.result);
+        case OpCode::DECLARE:
+            return line + "Declared " + bytecode.names[instr.dst] + " = " + std::to_string(record.result);
+        case OpCode::ADD:
+        case OpCode::SUBTRACT:
+            return line + bytecode.names[instr.dst] + " = " + std::to_string(record.operand1) +
+                (record.op == OpCode::ADD ? " + " : " - ") + std::to_string(record.operand2) +
+                " = " + std::to_string(record.result);
+        case OpCode::SLEEP:
+            return line + "Sleeping for " + std::to_string(instr.arg) + " CPU ticks";
+        case OpCode::LOOP_BEGIN:
+            return line + "Starting FOR loop (" + std::to_string(instr.arg) + " iterations)";
+        case OpCode::READ:
+            return line + "Read value " + std::to_string(record.result) + " from 0x" +
+                std::to_string(instr.arg) + " into " + bytecode.names[instr.dst];
+        case OpCode::WRITE:
+            return line + "Wrote value " + std::to_string(record.result) + " (from " +
+                bytecode.names[instr.a] + ") to 0x" + std::to_string(instr.arg);
+        default:
+            return line + "(unknown)";
     }
 }
 
-void Process::runInstructions() {
-    for (const auto& cmdPtr : instructions) {
-        if (cmdPtr) {
-            cmdPtr->execute(*this);
+// Scans the bytecode straight on from ip, without following loops back, and
+// appends each in-range page a READ or WRITE touches, skipping repeats.
+void Process::getUpcomingPages(size_t lookahead, std::vector<int>& pages, bool writes_only) const {
+    const size_t page_size = page_table->getPageSize();
+    size_t end = std::min(bytecode.code.size(), ip + lookahead);
+    for (size_t i = ip; i < end; ++i) {
+        const Instr& instr = bytecode.code[i];
+        if (instr.op != OpCode::WRITE && (writes_only || instr.op != OpCode::READ)) continue;
+        if (instr.arg >= memory_size) continue;
+        int page = (int)(instr.arg / page_size);
+        if (std::find(pages.begin(), pages.end(), page) == pages.end()) pages.push_back(page);
+    }
+}
+
+// Runs bytecode until slice_size top-level instructions have completed, the
+// process leaves the RUNNING state (SLEEP, termination), or an instruction
+// needs a page that is not resident. In the last case nothing is executed
+// and the page is reported so the caller can fault it in and call again.
+SliceResult Process::runInstructionSlice(unsigned int slice_size) {
+    SliceResult result;
+    if (state != ProcessState::RUNNING) return result;
+
+    if (woke_from_sleep) {
+        woke_from_sleep = false;
+        logOp(LogKind::WOKE_UP);
+    }
+
+    const Instr* code = bytecode.code.data();
+    const size_t code_size = bytecode.code.size();
+    const size_t page_size = page_table->getPageSize();
+
+    while (result.retired < slice_size && ip < code_size) {
+        const Instr& instr = code[ip];
+
+        // READ/WRITE touch the page holding their address, and find out
+        // whether it is resident when the MMU translates the access.
+        // Everything else touches the symbol table on page 0.
+        int page = 0;
+        if (instr.op == OpCode::READ || instr.op == OpCode::WRITE) {
+            if (instr.arg >= memory_size) {
+                terminateWithViolation(instr.arg);
+                break;
+            }
+            page = (int)(instr.arg / page_size);
+        } else if (!page_table->isPresent(page)) {
+            result.fault_page = page;
+            break;
+        } else {
+            page_table->setReferenced(page, true);
         }
+
+        size_t next = ip + 1;
+        bool retires = (instr.flags & RETIRES_LINE) != 0;
+
+        switch (instr.op) {
+            case OpCode::PRINT_HELLO:
+                logOp(LogKind::INSTRUCTION);
+                break;
+            case OpCode::PRINT_MESSAGE:
+                logOp(LogKind::INSTRUCTION);
+                break;
+            case OpCode::PRINT_VAR:
+                logOp(LogKind::INSTRUCTION, 0, 0, symbol_values[instr.a]);
+                break;
+            case OpCode::PRINT_COMBINED:
+                logOp(LogKind::INSTRUCTION, 0, 0, symbol_values[instr.a]);
+                break;
+            case OpCode::DECLARE:
+                setSymbol(instr.dst, (uint16_t)instr.arg);
+                logOp(LogKind::INSTRUCTION, 0, 0, (uint16_t)instr.arg);
+                break;
+            case OpCode::ADD:
+            case OpCode::SUBTRACT: {
+                uint16_t op1 = (instr.flags & OPERAND_A_IMM) ? instr.a : symbol_values[instr.a];
+                uint16_t op2 = (instr.flags & OPERAND_B_IMM) ? instr.b : symbol_values[instr.b];
+                uint16_t value;
+                if (instr.op == OpCode::ADD) {
+                    uint32_t sum = (uint32_t)op1 + (uint32_t)op2;
+                    value = (uint16_t)std::min<uint32_t>(sum, std::numeric_limits<uint16_t>::max());
+                } else {
+                    value = (op1 >= op2) ? (uint16_t)(op1 - op2) : 0;
+                }
+                setSymbol(instr.dst, value);
+                logOp(LogKind::INSTRUCTION, op1, op2, value);
+                break;
+            }
+            case OpCode::SLEEP:
+                logOp(LogKind::INSTRUCTION);
+                // The core is released rather than held: the scheduler parks
+                // the process until this tick.
+                sleepUntil(g_cpu_tick + instr.arg);
+                break;
+            case OpCode::LOOP_BEGIN:
+                logOp(LogKind::INSTRUCTION);
+                loop_stack.push_back(instr.arg);
+                if (instr.arg == 0) next = instr.target;
+                break;
+            case OpCode::LOOP_END:
+                if (loop_stack.back() > 1) {
+                    loop_stack.back()--;
+                    next = instr.target;
+                    retires = false;
+                } else {
+                    loop_stack.pop_back();
+                    logOp(LogKind::LOOP_DONE);
+                }
+                break;
+            case OpCode::READ: {
+                uint16_t value_read = 0;
+                if (!g_memory_manager->readWord(*this, instr.arg, value_read)) {
+                    result.fault_page = page;
+                    break;
+                }
+                setSymbol(instr.dst, value_read);
+                logOp(LogKind::INSTRUCTION, 0, 0, value_read);
+                break;
+            }
+            case OpCode::WRITE: {
+                uint16_t value_to_write = symbol_values[instr.a];
+                if (!g_memory_manager->writeWord(*this, instr.arg, value_to_write)) {
+                    result.fault_page = page;
+                    result.fault_write = true;
+                    break;
+                }
+                logOp(LogKind::INSTRUCTION, 0, 0, value_to_write);
+                break;
+            }
+            case OpCode::UNKNOWN:
+                std::cerr << "[Process " << process_name << "] "
+                          << "ERROR: Unknown command encountered. Reason: " << bytecode.strings[instr.arg] << std::endl;
+                break;
+        }
+
+        if (result.fault_page >= 0) break;
+        result.page_hits++;
+
+        ip = next;
+        if (retires) {
+            program_counter++;
+            result.retired++;
+        }
+        if (state != ProcessState::RUNNING) break;
     }
-    // end_time = std::chrono::system_clock::now();
+
+    return result;
 }
 
 void Process::displayVariables() const {
     std::cout << "--- Symbol Table for PID " << this->pid << " ---\n";
-    if (symbol_count == 0) {
+    if (symbol_order.empty()) {
         std::cout << "  (empty)\n";
         return;
     }
 
-    // Iterate only through the variables that are currently in use.
-    for (size_t i = 0; i < symbol_count; ++i) {
-        if (symbol_table[i].in_use) {
-            std::cout << "  [" << i << "] " << symbol_table[i].name 
-                      << " = " << symbol_table[i].value << std::endl;
-        }
+    // Slots in the order they were declared.
+    for (size_t i = 0; i < symbol_order.size(); ++i) {
+        uint16_t slot = symbol_order[i];
+        std::cout << "  [" << i << "] " << bytecode.names[slot] 
+                  << " = " << symbol_values[slot] << std::endl;
     }
     std::cout << "------------------------------------\n";
 }
@@ -250,13 +619,22 @@ double updateRunningAverage(double previous_average, uint64_t new_wait, size_t i
     return (previous_average * (double)index + new_wait) / (index + 1);
 }
 
+// Free-text entries (system notices) are rare; they keep their string.
 void Process::addLog(const std::string& message) {
     std::lock_guard<std::mutex> lock(logMutex);
-    logs.push_back(message);
+    LogRecord record{};
+    record.tick = g_cpu_tick;
+    record.kind = LogKind::NOTE;
+    record.ip = log_notes_archived + (uint32_t)log_notes.size();
+    log_notes.push_back(message);
+    appendLog(record);
 }
 
 void Process::runScreenInterface() {
     std::string command;
+    // Shows the newest page until the user pages back with 'prev'.
+    bool follow_tail = true;
+    uint64_t page_start = 0;
     while (true) {
         clear_screen(); // Assumes this is a global function
 
@@ -264,15 +642,20 @@ void Process::runScreenInterface() {
         std::cout << "Process name: " << this->getProcessName() << std::endl;
         std::cout << "ID: " << this->getPid() << std::endl;
         
-        std::cout << "Logs:" << std::endl;
-        {
-            std::lock_guard<std::mutex> lock(this->logMutex);
-            if (logs.empty()) {
-                std::cout << "  (No log entries yet.)\n";
-            } else {
-                for (const auto& log_entry : logs) {
-                    std::cout << log_entry << std::endl;
-                }
+        uint64_t total = this->getLogCount();
+        if (follow_tail) {
+            page_start = total > LOG_PAGE_SIZE ? total - LOG_PAGE_SIZE : 0;
+        }
+
+        if (total == 0) {
+            std::cout << "Logs:" << std::endl;
+            std::cout << "  (No log entries yet.)\n";
+        } else {
+            std::vector<std::string> page = this->getLogs(page_start, LOG_PAGE_SIZE);
+            std::cout << "Logs (" << page_start + 1 << "-" << page_start + page.size()
+                      << " of " << total << "):" << std::endl;
+            for (const auto& line : page) {
+                std::cout << line << std::endl;
             }
         }
         
@@ -295,38 +678,21 @@ void Process::runScreenInterface() {
         } else if (command == "process-smi") {
             // The loop will automatically refresh, so we just continue
             continue;
+        } else if (command == "prev") {
+            follow_tail = false;
+            page_start = page_start > LOG_PAGE_SIZE ? page_start - LOG_PAGE_SIZE : 0;
+        } else if (command == "next") {
+            page_start += LOG_PAGE_SIZE;
+            if (page_start + LOG_PAGE_SIZE >= this->getLogCount()) {
+                follow_tail = true;
+            }
         } else {
-            std::cout << "Unknown command. Use 'process-smi' to refresh or 'exit' to return." << std::endl;
+            std::cout << "Unknown command. Use 'process-smi' to refresh, 'prev'/'next' to page through the log, or 'exit' to return." << std::endl;
             system("pause");
         }
     }
 }
 
-uint16_t Process::readMemory(uint32_t address) const {
-    // The address from the command is a byte address. We need to convert
-    // it to an index into our vector of 2-byte words.
-    size_t index = address / 2;
-
-    // Boundary check
-    if (index >= memory_space.size()) {
-        // This case should be caught by the ICommand's access violation check,
-        // but it's good practice to have a safe fallback.
-        return 0; 
-    }
-    return memory_space[index];
-}
-
-void Process::writeMemory(uint32_t address, uint16_t value) {
-    size_t index = address / 2;
-
-    // Boundary check
-    if (index >= memory_space.size()) {
-        // Again, this is a safety fallback. The ICommand should prevent this.
-        return;
-    }
-    memory_space[index] = value;
-}
-
 size_t Process::getMemorySize() const {
     return memory_size;
 }
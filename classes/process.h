@@ -5,18 +5,24 @@
 #include <unordered_map>
 #include <chrono>
 #include <vector>
+#include <deque>
 #include <memory> 
 #include <mutex>
 #include <inttypes.h>
 #include "ICommand.h"
 #include "PageTable.h"
+#include "LogRecord.h"
+#include "LogArchive.h"
 
 enum class ProcessState {
     IDLE,
     WAITING,
     RUNNING,
+    SLEEPING,
     FINISHED,
-    TERMINATED 
+    TERMINATED,
+    BLOCKED,        // waiting for a page to be brought in
+    SUSPENDED       // held back by admission control until memory frees up
 };
 
 std::string processStateToString(ProcessState state);
@@ -27,6 +33,9 @@ private:
     uint16_t pid;
     std::string process_name;
     std::vector<std::unique_ptr<ICommand>> instructions;
+    Bytecode bytecode;                  // instructions, lowered; this is what runs
+    size_t ip = 0;                      // index into bytecode.code
+    std::vector<uint32_t> loop_stack;   // iterations left in each enclosing FOR
     // std::chrono::time_point<std::chrono::system_clock> start_time;       //we should be counting time according to hypothetical CPU ticks
     // std::chrono::time_point<std::chrono::system_clock> end_time;         //not actual system time
     uint64_t arrival_time;          //do we just compute for this during runtime and not store it in a variable?
@@ -37,17 +46,23 @@ private:
     uint64_t end_time[MAX];         //arbitrary size of 1024
     size_t run_count;
     size_t program_counter;
+    uint64_t wake_tick = 0;         // while SLEEPING: g_cpu_tick to wake at
+    bool woke_from_sleep = false;   // log the wake-up once we are back on a core
+    int blocked_page = -1;          // while BLOCKED: page being brought in
+    bool blocked_write = false;     // ...for a WRITE
+    bool resumed_from_fault = false;    // paged in, no instruction retired since
 
     int current_core_id;            //need -1 for unassigned core
     ProcessState state;
 
-    struct SymbolTableEntry {
-        std::string name;
-        uint16_t value;
-        bool in_use = false;
-    };
-    SymbolTableEntry symbol_table[32]; 
-    size_t symbol_count = 0;
+    // Symbol table, indexed by the slot each name was interned to in
+    // bytecode.names, so a variable access is one array load. Undeclared
+    // slots read as 0. Only the first MAX_SYMBOLS names to be declared get
+    // storage; symbol_order lists them in declaration order.
+    static const size_t MAX_SYMBOLS = 32;
+    std::vector<uint16_t> symbol_values;
+    std::vector<bool> symbol_declared;
+    std::vector<uint16_t> symbol_order;
 
     size_t memory_size; 
     std::unique_ptr<PageTable> page_table;
@@ -59,22 +74,46 @@ private:
 
     std::string creation_timestamp_str;
 
-    std::vector<uint16_t> memory_space;
-
-    std::vector<std::string> logs;
-    std::mutex logMutex;
+    // The newest records live in a ring of log-buffer-size entries. When it
+    // fills, the older half is spilled to the LogArchive; log_archived is
+    // how many records (the oldest ones) are on disk.
+    std::vector<LogRecord> log_ring;
+    size_t log_head = 0;                    // oldest buffered record
+    size_t log_buffered = 0;
+    uint64_t log_archived = 0;
+    // Text of NOTE records not yet archived, from note number
+    // log_notes_archived on. A note follows its record to the archive.
+    std::deque<std::string> log_notes;
+    uint32_t log_notes_archived = 0;
+    mutable std::mutex logMutex;
+
+    void appendLog(const LogRecord& record);
+    void spillLogs(size_t count);
+    void logOp(LogKind kind, uint16_t operand1 = 0, uint16_t operand2 = 0, uint16_t result = 0);
+    std::string renderLog(const LogRecord& record) const;
+    int findSymbol(const std::string& name) const;
 
 public:
     Process();
-    Process(int id, const std::string& name, size_t mem_size, size_t page_size);
+    Process(int id, const std::string& name, size_t mem_size, size_t page_size, int page_table_levels = 1);
     ~Process();
 
     void addInstruction(std::unique_ptr<ICommand> instruction);
-    void runInstructionSlice(unsigned int slice_size);
-    void runInstructions();
+    // A new IDLE process running the same program from the same point with
+    // the same variables. Memory is not copied here: the caller shares it
+    // through MemoryManager::forkAddressSpace.
+    std::unique_ptr<Process> fork(int child_pid, const std::string& child_name) const;
+    SliceResult runInstructionSlice(unsigned int slice_size);
+    // Pages the next lookahead instructions will READ or WRITE (or only
+    // WRITE, if writes_only).
+    void getUpcomingPages(size_t lookahead, std::vector<int>& pages, bool writes_only = false) const;
 
     void addLog(const std::string& message);
     std::vector<std::string> getLogs() const;
+    std::vector<std::string> getLogs(uint64_t first, size_t count) const;
+    uint64_t getLogCount() const;
+    // Moves every buffered record to the archive and frees the ring.
+    void flushLogs();
 
     const std::vector<std::unique_ptr<ICommand>>& getInstructions() const;
     int getInstructionCount() const;
@@ -107,7 +146,19 @@ public:
     void setEndTime(uint64_t end);
     void setCurrentCoreId(int coreId);
     void setState(ProcessState newState);
+    void sleepUntil(uint64_t tick);
+    void wakeUp();
+    uint64_t getWakeTick() const;
+    // Takes the process off the CPU until page is mapped; the scheduler hands
+    // it to the pager, which calls pageArrived once it is in.
+    void blockOnPage(int page, bool write);
+    void pageArrived();
+    int getBlockedPage() const;
+    bool isBlockedOnWrite() const;
+    bool isResumedFromFault() const;
+    void setResumedFromFault(bool resumed);
     bool setVariable(const std::string& name, uint16_t value);
+    bool setSymbol(uint16_t slot, uint16_t value);
     void terminate(const std::string& reason);
     std::string getTerminationReason() const;
 
@@ -123,8 +174,5 @@ public:
 
     double updateRunningAverage(double previous_average, uint64_t new_wait, size_t index);
 
-    uint16_t readMemory(uint32_t address) const;
-    void writeMemory(uint32_t address, uint16_t value);
-
     void runScreenInterface(); 
 };
@@ -9,6 +9,7 @@ void initialize();
 void screen_init();
 void scheduler_start();
 void scheduler_stop();
+void scheduler_turbo(size_t, unsigned int);
 void report_util();
 void clear_screen();
 bool accept_input(std::string, Process*);
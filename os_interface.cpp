@@ -39,6 +39,17 @@ int delays_perexec = 0;
 int max_overall_mem = 0;
 int mem_per_frame = 0;
 int mem_per_proc = 0;
+std::string page_replacement = "fifo";
+// "paging", or "flat": one contiguous block per process, no backing store
+std::string memory_mode = "paging";
+std::string flat_allocator = "first-fit";
+int compaction_threshold = 0;     // flat mode; % of free memory outside the largest hole, 0 = off
+// 1: each process gets one array of page table entries; 2: a directory of
+// leaf tables, allocated as pages are touched, for large sparse processes
+int page_table_levels = 1;
+
+// log records each process keeps in memory before spilling to disk
+int log_buffer_size = 256;
 
 //initialization of Screens and Processes Lists
 Scheduler* os_scheduler = nullptr;
@@ -46,12 +57,19 @@ Scheduler* os_scheduler = nullptr;
 // Global memory manager pointer
 MemoryManager* g_memory_manager = nullptr;
 
+// Per-run archive of spilled process logs
+LogArchive* g_log_archive = nullptr;
+
 // p_id
 int g_next_pid = 1;
 // process generator thread
 std::thread g_process_generator_thread;
 // process generator thread flag
 bool g_is_generating = false;
+// time between generator batches
+const int GENERATOR_PERIOD_MS = 5000;
+// ticks screen -f waits for a running parent to leave its core
+const int FORK_ATTEMPTS = 100;
 
 
 std::mutex screenListMutex;
@@ -133,25 +151,75 @@ void initialize() {
             if (mem_per_proc < 1) {
                 std::cerr << "Invalid mem-per-proc value. Must be >=1." << std::endl;
             }
+        } else if (key == "page-replacement") {
+            iss >> page_replacement;
+            for (char &c : page_replacement) {
+                c = std::tolower(static_cast<unsigned char>(c));
+            }
+            if (page_replacement != "fifo" && page_replacement != "clock" && page_replacement != "lru" &&
+                page_replacement != "lfu" && page_replacement != "wsclock") {
+                std::cerr << "Invalid page-replacement value. Must be 'fifo', 'clock', 'lru', 'lfu' or 'wsclock'." << std::endl;
+                page_replacement = "fifo";
+            }
+        } else if (key == "memory-mode") {
+            iss >> memory_mode;
+            if (memory_mode != "paging" && memory_mode != "flat") {
+                std::cerr << "Invalid memory-mode value. Must be 'paging' or 'flat'." << std::endl;
+                memory_mode = "paging";
+            }
+        } else if (key == "flat-allocator") {
+            iss >> flat_allocator;
+            if (flat_allocator != "first-fit" && flat_allocator != "best-fit" && flat_allocator != "buddy") {
+                std::cerr << "Invalid flat-allocator value. Must be 'first-fit', 'best-fit' or 'buddy'." << std::endl;
+                flat_allocator = "first-fit";
+            }
+        } else if (key == "compaction-threshold") {
+            iss >> compaction_threshold;
+            if (compaction_threshold < 0 || compaction_threshold > 100) {
+                std::cerr << "Invalid compaction-threshold value. Must be in [0,100]." << std::endl;
+                compaction_threshold = 0;
+            }
+        } else if (key == "page-table-levels") {
+            iss >> page_table_levels;
+            if (page_table_levels != 1 && page_table_levels != 2) {
+                std::cerr << "Invalid page-table-levels value. Must be 1 or 2." << std::endl;
+                page_table_levels = 1;
+            }
+        } else if (key == "log-buffer-size") {
+            iss >> log_buffer_size;
+            if (log_buffer_size < 2) {
+                std::cerr << "Invalid log-buffer-size value. Must be >=2." << std::endl;
+                log_buffer_size = 2;
+            }
         } else {
             std::cerr << "Unknown configuration key: " << key << std::endl;
 
         }
     };
-    g_memory_manager = new MemoryManager(max_overall_mem, mem_per_frame, mem_per_proc);
+    g_memory_manager = new MemoryManager(max_overall_mem, mem_per_frame, page_replacement,
+                                         memory_mode, flat_allocator, compaction_threshold);
+    // Kept across re-initialization so earlier processes can still page
+    // through their history; turbo runs start a fresh one.
+    if (!g_log_archive) {
+        g_log_archive = new LogArchive("csopesy-process-logs.bin", log_buffer_size);
+    }
     os_scheduler = new Scheduler(scheduler_type, quantumcycles, g_memory_manager, delays_perexec);
     
 
     config.close();
 }
 
+// Fixed name pools so generated programs share a handful of interned names.
+const std::string VAR_NAMES[] = { "var0", "var1", "var2", "var3", "var4", "var5", "var6", "var7", "var8", "var9" };
+const std::string RESULT_NAMES[] = { "result0", "result1", "result2", "result3", "result4" };
+
 ICommand* generateRandomInstruction() {
 
     int instruction_type = rand() % 8; 
 
-    std::string randomVarName1 = "var" + std::to_string(rand() % 10);
-    std::string randomVarName2 = "var" + std::to_string(rand() % 10);
-    std::string resultVarName = "result" + std::to_string(rand() % 5);
+    const std::string& randomVarName1 = VAR_NAMES[rand() % 10];
+    const std::string& randomVarName2 = VAR_NAMES[rand() % 10];
+    const std::string& resultVarName = RESULT_NAMES[rand() % 5];
 
     switch (instruction_type) {
         case 0: // PRINT
@@ -192,10 +260,14 @@ ICommand* generateRandomInstruction() {
             return new UNKNOWN;
     }
 }
-// Accepts a memory size only if it is a power of 2 within [64, 65536] bytes.
+// Largest address space screen -s/-c accept. Untouched pages cost no frames,
+// and with page-table-levels 2 little table either.
+const size_t MAX_PROCESS_MEMORY = (size_t)1 << 26;
+
+// Accepts a memory size only if it is a power of 2 within [64, MAX_PROCESS_MEMORY] bytes.
 bool isValidProcessMemory(size_t mem_size) {
     bool is_power_of_two = (mem_size > 0) && ((mem_size & (mem_size - 1)) == 0);
-    return is_power_of_two && mem_size >= 64 && mem_size <= 65536;
+    return is_power_of_two && mem_size >= 64 && mem_size <= MAX_PROCESS_MEMORY;
 }
 
 // Helper function : converts \" to " and \\ to \ so instruction strings can carry quoted
@@ -390,14 +462,10 @@ std::vector<std::unique_ptr<ICommand>> parseInstructionString(const std::string&
 }
 
 Process* create_new_process(std::string name) {
-    std::default_random_engine generator(
-        std::chrono::system_clock::now().time_since_epoch().count()
-    );
-
-    std::uniform_int_distribution<int> instructionDist(min_ins, max_ins);
-    int num_instructions = instructionDist(generator);
+    // rand() rather than a clock-seeded engine so a seeded turbo run is reproducible
+    int num_instructions = min_ins + rand() % (max_ins - min_ins + 1);
 
-    auto proc = std::make_unique<Process>(g_next_pid, name, mem_per_proc, mem_per_frame);
+    auto proc = std::make_unique<Process>(g_next_pid, name, mem_per_proc, mem_per_frame, page_table_levels);
 
     //TEMP 
     Process* raw_ptr = proc.get();
@@ -422,14 +490,10 @@ Process* create_new_process(std::string name) {
 Process* create_new_process(std::string name, size_t mem_size) {
     if (!os_scheduler) return nullptr;
 
-    std::default_random_engine generator(
-        std::chrono::system_clock::now().time_since_epoch().count()
-    );
+    // rand() rather than a clock-seeded engine so a seeded turbo run is reproducible
+    int num_instructions = min_ins + rand() % (max_ins - min_ins + 1);
 
-    std::uniform_int_distribution<int> instructionDist(min_ins, max_ins);
-    int num_instructions = instructionDist(generator);
-
-    auto proc = std::make_unique<Process>(g_next_pid, name, mem_size, mem_per_frame);
+    auto proc = std::make_unique<Process>(g_next_pid, name, mem_size, mem_per_frame, page_table_levels);
     Process* raw_ptr = proc.get();
 
     for (int i = 0; i < num_instructions; ++i) {
@@ -448,7 +512,7 @@ Process* create_new_process(std::string name, size_t mem_size) {
 Process* create_new_process(std::string name, size_t mem_size, std::vector<std::unique_ptr<ICommand>> program) {
     if (!os_scheduler) return nullptr;
 
-    auto proc = std::make_unique<Process>(g_next_pid, name, mem_size, mem_per_frame);
+    auto proc = std::make_unique<Process>(g_next_pid, name, mem_size, mem_per_frame, page_table_levels);
     Process* raw_ptr = proc.get();
 
 
@@ -466,6 +530,26 @@ Process* create_new_process(std::string name, size_t mem_size, std::vector<std::
     return raw_ptr;
 }
 
+// Used by "screen -f <src> <dst>". The child shares the parent's memory
+// copy-on-write, so nothing is copied until one of them writes.
+Process* fork_process(Process* parent, std::string name) {
+    if (!os_scheduler || !g_memory_manager) return nullptr;
+
+    // A parent on a core is mid-instruction; give it a few ticks to come off.
+    std::unique_ptr<Process> child;
+    for (int attempt = 0; attempt < FORK_ATTEMPTS && !child; ++attempt) {
+        child = os_scheduler->forkParked(parent, g_next_pid, name);
+        if (!child) std::this_thread::sleep_for(std::chrono::milliseconds(TICK_MS));
+    }
+    if (!child) return nullptr;
+    Process* raw_ptr = child.get();
+
+    os_scheduler->addProcess(std::move(child));
+    g_next_pid++;
+
+    return raw_ptr;
+}
+
 
 void generate_random_processes() {
 
@@ -513,12 +597,125 @@ void scheduler_start() {
                 create_new_process("Process" + std::to_string(g_next_pid));
             }
             os_scheduler->queueProcesses(); 
-            std::this_thread::sleep_for(std::chrono::seconds(5));
+            std::this_thread::sleep_for(std::chrono::milliseconds(GENERATOR_PERIOD_MS));
         }
     });
 }
 
 
+// Turbo mode: re-initializes the emulator and runs num_processes generated
+// processes to completion on the virtual clock, single-threaded. The same
+// seed and config.txt always give the same run.
+void scheduler_turbo(size_t num_processes, unsigned int seed) {
+    if (g_is_generating) {
+        std::cout << "Error: Stop the running scheduler before starting a turbo run.\n";
+        return;
+    }
+    if (os_scheduler && os_scheduler->isSchedulerRunning()) {
+        // The cores stay up after a real-time run's processes finish; shut
+        // them down once there is nothing left for them.
+        if (!os_scheduler->isDrained()) {
+            std::cout << "Error: Wait for the running scheduler's processes to finish before starting a turbo run.\n";
+            return;
+        }
+        os_scheduler->stopScheduler();
+    }
+    if (g_process_generator_thread.joinable()) g_process_generator_thread.join();
+
+    delete os_scheduler;
+    delete g_memory_manager;
+    delete g_log_archive;
+    os_scheduler = nullptr;
+    g_memory_manager = nullptr;
+    g_log_archive = nullptr;
+
+    initialize();
+    if (!os_scheduler) return;
+
+    srand(seed);
+    g_next_pid = 1;
+    g_cpu_tick = 0;
+    g_virtual_time = true;
+
+    size_t created = 0;
+    auto generate_batch = [&]() {
+        for (int i = 0; i < batchprocess_freq && created < num_processes; ++i, ++created) {
+            create_new_process("Process" + std::to_string(g_next_pid));
+        }
+        return created < num_processes;
+    };
+
+    auto wall_start = std::chrono::steady_clock::now();
+    os_scheduler->runVirtual(num_cpu, GENERATOR_PERIOD_MS / TICK_MS, generate_batch);
+    auto wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - wall_start).count();
+
+    g_virtual_time = false;
+
+    // FNV-1a over every process's final state, in PID order, so two runs can
+    // be compared at a glance.
+    std::vector<Process*> all_procs = os_scheduler->getAllProcesses();
+    std::sort(all_procs.begin(), all_procs.end(),
+              [](Process* a, Process* b) { return a->getPid() < b->getPid(); });
+    uint64_t digest = 1469598103934665603ULL;
+    auto mix = [&](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            digest ^= (value >> (i * 8)) & 0xFF;
+            digest *= 1099511628211ULL;
+        }
+    };
+    size_t finished = 0, terminated = 0;
+    for (Process* proc : all_procs) {
+        if (proc->getState() == ProcessState::FINISHED) finished++;
+        if (proc->getState() == ProcessState::TERMINATED) terminated++;
+        mix(proc->getPid());
+        mix((uint64_t)proc->getState());
+        mix(proc->getProgramCounter());
+        auto variables = proc->getVariables();
+        std::vector<std::pair<std::string, uint16_t>> sorted(variables.begin(), variables.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (const auto& var : sorted) {
+            for (char c : var.first) mix((unsigned char)c);
+            mix(var.second);
+        }
+    }
+
+    const int label_width = 18;
+    std::cout << std::left << std::setw(label_width) << "Seed:" << seed << "\n";
+    std::cout << std::left << std::setw(label_width) << "Processes:" << all_procs.size()
+              << " (" << finished << " finished, " << terminated << " terminated)\n";
+    std::cout << std::left << std::setw(label_width) << "Virtual Ticks:" << g_cpu_tick.load() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Active Ticks:" << os_scheduler->getActiveTicks() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Idle Ticks:" << os_scheduler->getIdleTicks() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Pages Paged In:" << g_memory_manager->getNumPagedIn() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Pages Paged Out:" << g_memory_manager->getNumPagedOut() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Minor Faults:" << g_memory_manager->getNumMinorFaults() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Major Faults:" << g_memory_manager->getNumMajorFaults() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Zero Page Maps:" << g_memory_manager->getNumZeroPageMaps() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Read-ahead Pages:" << g_memory_manager->getNumReadaheadPages() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Read-ahead Hits:" << g_memory_manager->getNumReadaheadHits() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Read-ahead Waste:" << g_memory_manager->getNumReadaheadWasted() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Prefetched:" << g_memory_manager->getNumPrefetchPages() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Prefetch Used:" << g_memory_manager->getNumPrefetchUsed() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Prefetch Unused:" << g_memory_manager->getNumPrefetchWasted() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Deferred Admits:" << os_scheduler->getNumAdmissionDeferrals() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Thrash Episodes:" << g_memory_manager->getNumThrashEpisodes() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Swap-outs:" << g_memory_manager->getNumProcessSwapOuts() << "\n";
+    std::cout << std::left << std::setw(label_width) << "Swap-ins:" << g_memory_manager->getNumProcessSwapIns() << "\n";
+    if (g_memory_manager->isFlat()) {
+        std::cout << std::left << std::setw(label_width) << "Memory Mode:" << g_memory_manager->getMemoryModeName() << "\n";
+        std::cout << std::left << std::setw(label_width) << "Allocations:" << g_memory_manager->getNumFlatAllocations() << "\n";
+        std::cout << std::left << std::setw(label_width) << "Alloc Failures:" << g_memory_manager->getNumFlatFailures() << "\n";
+        std::cout << std::left << std::setw(label_width) << "Alloc Retries:" << g_memory_manager->getNumFlatRetries() << "\n";
+        std::cout << std::left << std::setw(label_width) << "Compactions:" << g_memory_manager->getNumCompactions() << "\n";
+        std::cout << std::left << std::setw(label_width) << "Avg Alloc Time:" << std::fixed << std::setprecision(3)
+                  << g_memory_manager->getAvgFlatAllocMicros() << " us\n" << std::defaultfloat;
+    }
+    std::cout << std::left << std::setw(label_width) << "Wall Time:" << wall_ms << " ms\n";
+    std::cout << std::left << std::setw(label_width) << "Result Digest:" << std::hex << digest << std::dec << "\n";
+}
+
+
 void scheduler_stop() {
     g_is_generating = false;
     std::cout << "Scheduler stopped.\n";
@@ -554,11 +751,26 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
         std::cout << "Delays per Execution: " << delays_perexec << "\n\n";
         std::cout << "Max Overall Memory: " << max_overall_mem << "\n";
         std::cout << "Memory per Frame: " << mem_per_frame << "\n";
-        std::cout << "Memory per Process: " << mem_per_proc << "\n\n\n\n";
+        std::cout << "Memory per Process: " << mem_per_proc << "\n";
+        std::cout << "Page Replacement: " << page_replacement << "\n";
+        std::cout << "Page Table Levels: " << page_table_levels << "\n\n\n\n";
         system("pause");
     } else if (choice == "scheduler-start") {
         scheduler_start();
         system("pause");
+    } else if (choice.rfind("scheduler-turbo", 0) == 0) {
+        std::stringstream ss(choice);
+        std::string command;
+        size_t num_processes = 0;
+        unsigned int seed = 1;
+        ss >> command >> num_processes;
+        if (ss.fail() || num_processes == 0) {
+            std::cout << "Error: Invalid format. Usage: scheduler-turbo <num_processes> [seed]\n";
+        } else {
+            ss >> seed;
+            scheduler_turbo(num_processes, seed);
+        }
+        system("pause");
     } else if (choice == "scheduler-stop") {
         scheduler_stop();
         system("pause");
@@ -574,7 +786,7 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
             if (name.empty() || ss.fail()) {
                 std::cout << "Error: Invalid format. Usage: screen -s <name> <memory_size>\n";
             } else if (!isValidProcessMemory(mem_size)) {
-                std::cout << "Error: Invalid memory allocation. Size must be a power of 2 between 64 and 65536.\n";
+                std::cout << "Error: Invalid memory allocation. Size must be a power of 2 between 64 and " << MAX_PROCESS_MEMORY << ".\n";
             } else if (os_scheduler->findProcessByName(name)) {
                 std::cout << "Error: Process with that name already exists.\n";
             } else {
@@ -662,6 +874,33 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
         }
         system("pause");
 
+    } else if (choice.rfind("screen -f", 0) == 0) {
+        if (!os_scheduler) {
+            std::cout << "Scheduler not initialized. Please run 'initialize' first.\n";
+        } else {
+            std::stringstream ss(choice);
+            std::string command, flag, source, name;
+            ss >> command >> flag >> source >> name;
+
+            Process* parent = source.empty() ? nullptr : os_scheduler->findProcessByName(source);
+            if (name.empty()) {
+                std::cout << "Error: Invalid format. Usage: screen -f <source> <name>\n";
+            } else if (g_memory_manager->isFlat()) {
+                std::cout << "Error: screen -f needs memory-mode paging.\n";
+            } else if (!parent) {
+                std::cout << "Process '" << source << "' not found.\n";
+            } else if (parent->getState() == ProcessState::FINISHED ||
+                       parent->getState() == ProcessState::TERMINATED) {
+                std::cout << "Error: Process '" << source << "' has already finished.\n";
+            } else if (os_scheduler->findProcessByName(name)) {
+                std::cout << "Error: Process with that name already exists.\n";
+            } else if (!fork_process(parent, name)) {
+                std::cout << "Error: Process '" << source << "' did not come off its core; try again.\n";
+            } else {
+                std::cout << "Process '" << name << "' forked from '" << source << "'.\n";
+            }
+        }
+        system("pause");
     } else if (choice.rfind("screen -c", 0) == 0) {
  
         size_t first_quote = choice.find('"');
@@ -694,7 +933,7 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
             unescapeInstructionString(choice.substr(first_quote + 1, last_quote - first_quote - 1));
 
         if (!isValidProcessMemory(mem_size)) {
-            std::cout << "Error: Invalid memory allocation. Size must be a power of 2 between 64 and 65536.\n";
+            std::cout << "Error: Invalid memory allocation. Size must be a power of 2 between 64 and " << MAX_PROCESS_MEMORY << ".\n";
             system("pause");
             return;
         }
@@ -773,6 +1012,28 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
         system("pause");  
     } else if (choice == "report-util") {
 
+    } else if (choice.rfind("memory-stamp", 0) == 0) {
+        if (!g_memory_manager) {
+            std::cout << "Error: System not fully initialized. Please run 'initialize' first.\n";
+        } else {
+            std::stringstream ss(choice);
+            std::string command, which;
+            ss >> command >> which;
+            if (which == "all") {
+                size_t written = g_memory_manager->renderAllMemoryStamps();
+                std::cout << "Wrote " << written << " memory stamp(s).\n";
+            } else {
+                uint64_t quantum = g_memory_manager->getLastSnapshotQuantum();
+                std::stringstream qs(which);
+                if (!which.empty() && !(qs >> quantum)) {
+                    std::cout << "Error: Invalid format. Usage: memory-stamp [<quantum>|all]\n";
+                } else if (g_memory_manager->renderMemoryStamp(quantum)) {
+                    std::cout << "Wrote memory_stamp_" << std::setw(2) << std::setfill('0') << quantum
+                              << std::setfill(' ') << ".txt\n";
+                }
+            }
+        }
+        system("pause");
     } else if (choice == "vmstat") {
         if (!g_memory_manager || !os_scheduler) {
             std::cout << "Error: System not fully initialized. Please run 'initialize' first.\n";
@@ -784,6 +1045,40 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
 
             size_t paged_in = g_memory_manager->getNumPagedIn();
             size_t paged_out = g_memory_manager->getNumPagedOut();
+            size_t readahead_pages = g_memory_manager->getNumReadaheadPages();
+            size_t readahead_hits = g_memory_manager->getNumReadaheadHits();
+            size_t readahead_wasted = g_memory_manager->getNumReadaheadWasted();
+            size_t prefetch_pages = g_memory_manager->getNumPrefetchPages();
+            size_t prefetch_used = g_memory_manager->getNumPrefetchUsed();
+            size_t prefetch_wasted = g_memory_manager->getNumPrefetchWasted();
+            // Of the prefetched pages whose fate is known, how many were used.
+            double prefetch_accuracy = (prefetch_used + prefetch_wasted) > 0
+                ? 100.0 * prefetch_used / (prefetch_used + prefetch_wasted) : 0.0;
+            size_t swap_used = g_memory_manager->getSwapUsed();
+            size_t writeback_queue = g_memory_manager->getWritebackQueueDepth();
+            size_t pages_cleaned = g_memory_manager->getNumPagesCleaned();
+            size_t stalls_avoided = g_memory_manager->getNumStallsAvoided();
+            size_t page_hits = g_memory_manager->getNumPageHits();
+            size_t page_faults = g_memory_manager->getNumPageFaults();
+            size_t minor_faults = g_memory_manager->getNumMinorFaults();
+            size_t major_faults = g_memory_manager->getNumMajorFaults();
+            size_t zero_page_maps = g_memory_manager->getNumZeroPageMaps();
+            size_t cow_copies = g_memory_manager->getNumCowCopies();
+            size_t shared_slots = g_memory_manager->getNumSharedSlots();
+            size_t thrash_episodes = g_memory_manager->getNumThrashEpisodes();
+            size_t suspended = os_scheduler->getNumSuspended();
+            size_t deferrals = os_scheduler->getNumAdmissionDeferrals();
+            size_t swap_outs = g_memory_manager->getNumProcessSwapOuts();
+            size_t swap_ins = g_memory_manager->getNumProcessSwapIns();
+            size_t pages_swapped_out = g_memory_manager->getNumPagesSwappedOut();
+            size_t pages_swapped_in = g_memory_manager->getNumPagesSwappedIn();
+            // Entries, leaves and swap-slot arrays of every process still around.
+            size_t table_bytes = 0;
+            for (Process* proc : os_scheduler->getAllProcesses()) {
+                table_bytes += proc->getPageTable()->getTableBytes();
+            }
+            double hit_ratio = (page_hits + page_faults) > 0
+                ? 100.0 * page_hits / (page_hits + page_faults) : 0.0;
 
             size_t active_ticks = os_scheduler->getActiveTicks();
             size_t idle_ticks = os_scheduler->getIdleTicks();
@@ -792,12 +1087,57 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
 
             const int label_width = 18; 
         
+            std::cout << std::left << std::setw(label_width) << "Memory Mode:" << g_memory_manager->getMemoryModeName() << "\n";
             std::cout << std::left << std::setw(label_width) << "Total Memory:" << total_mem << " bytes\n";
             std::cout << std::left << std::setw(label_width) << "Used Memory:"  << used_mem << " bytes\n";
             std::cout << std::left << std::setw(label_width) << "Free Memory:"  << free_mem << " bytes\n";
             
+            if (g_memory_manager->isFlat()) {
+                size_t free_bytes = g_memory_manager->getExternalFragmentation();
+                size_t largest_hole = g_memory_manager->getLargestHole();
+                // Share of free memory no single allocation can use.
+                double fragmentation = free_bytes > 0 ? 100.0 * (free_bytes - largest_hole) / free_bytes : 0.0;
+                std::cout << std::left << std::setw(label_width) << "In Memory:" << g_memory_manager->getNumProcessesInMemory() << " processes\n";
+                std::cout << std::left << std::setw(label_width) << "Ext. Frag.:" << free_bytes << " bytes\n";
+                std::cout << std::left << std::setw(label_width) << "Largest Hole:" << largest_hole << " bytes\n";
+                std::cout << std::left << std::setw(label_width) << "Fragmentation:" << std::fixed << std::setprecision(2) << fragmentation << "%\n";
+                std::cout << std::left << std::setw(label_width) << "Int. Frag.:" << g_memory_manager->getInternalFragmentation() << " bytes\n";
+                std::cout << std::left << std::setw(label_width) << "Allocations:" << g_memory_manager->getNumFlatAllocations() << "\n";
+                std::cout << std::left << std::setw(label_width) << "Alloc Failures:" << g_memory_manager->getNumFlatFailures() << "\n";
+                std::cout << std::left << std::setw(label_width) << "Alloc Retries:" << g_memory_manager->getNumFlatRetries() << "\n";
+                std::cout << std::left << std::setw(label_width) << "Compactions:" << g_memory_manager->getNumCompactions() << "\n";
+                std::cout << std::left << std::setw(label_width) << "Avg Alloc Time:" << std::fixed << std::setprecision(3)
+                          << g_memory_manager->getAvgFlatAllocMicros() << " us\n";
+            }
             std::cout << std::left << std::setw(label_width) << "Pages Paged In:" << paged_in << "\n";
             std::cout << std::left << std::setw(label_width) << "Pages Paged Out:" << paged_out << "\n";
+            std::cout << std::left << std::setw(label_width) << "Read-ahead Pages:" << readahead_pages << "\n";
+            std::cout << std::left << std::setw(label_width) << "Read-ahead Hits:" << readahead_hits << "\n";
+            std::cout << std::left << std::setw(label_width) << "Read-ahead Waste:" << readahead_wasted << "\n";
+            std::cout << std::left << std::setw(label_width) << "Prefetched:" << prefetch_pages << "\n";
+            std::cout << std::left << std::setw(label_width) << "Prefetch Used:" << prefetch_used << "\n";
+            std::cout << std::left << std::setw(label_width) << "Prefetch Unused:" << prefetch_wasted << "\n";
+            std::cout << std::left << std::setw(label_width) << "Prefetch Useful:" << std::fixed << std::setprecision(2) << prefetch_accuracy << "%\n";
+            std::cout << std::left << std::setw(label_width) << "Swap Used:" << swap_used << " bytes\n";
+            std::cout << std::left << std::setw(label_width) << "Page Tables:" << table_bytes << " bytes\n";
+            std::cout << std::left << std::setw(label_width) << "Writeback Queue:" << writeback_queue << "\n";
+            std::cout << std::left << std::setw(label_width) << "Pages Cleaned:" << pages_cleaned << "\n";
+            std::cout << std::left << std::setw(label_width) << "Stalls Avoided:" << stalls_avoided << "\n";
+            std::cout << std::left << std::setw(label_width) << "Replacement:" << g_memory_manager->getReplacementPolicyName() << "\n";
+            std::cout << std::left << std::setw(label_width) << "Page Hits:" << page_hits << "\n";
+            std::cout << std::left << std::setw(label_width) << "Page Faults:" << page_faults << "\n";
+            std::cout << std::left << std::setw(label_width) << "Minor Faults:" << minor_faults << "\n";
+            std::cout << std::left << std::setw(label_width) << "Major Faults:" << major_faults << "\n";
+            std::cout << std::left << std::setw(label_width) << "Zero Page Maps:" << zero_page_maps << "\n";
+            std::cout << std::left << std::setw(label_width) << "COW Copies:" << cow_copies << "\n";
+            std::cout << std::left << std::setw(label_width) << "Shared Slots:" << shared_slots << "\n";
+            std::cout << std::left << std::setw(label_width) << "Hit Ratio:" << std::fixed << std::setprecision(2) << hit_ratio << "%\n";
+            std::cout << std::left << std::setw(label_width) << "Thrashing:" << (g_memory_manager->isThrashing() ? "yes" : "no") << "\n";
+            std::cout << std::left << std::setw(label_width) << "Thrash Episodes:" << thrash_episodes << "\n";
+            std::cout << std::left << std::setw(label_width) << "Suspended:" << suspended << "\n";
+            std::cout << std::left << std::setw(label_width) << "Deferred Admits:" << deferrals << "\n";
+            std::cout << std::left << std::setw(label_width) << "Swap-outs:" << swap_outs << " (" << pages_swapped_out << " pages)\n";
+            std::cout << std::left << std::setw(label_width) << "Swap-ins:" << swap_ins << " (" << pages_swapped_in << " pages)\n";
             
 
             std::cout << std::left << std::setw(label_width) << "Active Ticks:" << active_ticks << "\n";
@@ -811,12 +1151,15 @@ void accept_main_menu_input(std::string choice, OSState* current, Process** acti
             << "  initialize                              # read config.txt and start the OS environment\n"
             << "  screen -s <name> <mem_size>             # create a process with the given memory size\n"
             << "  screen -c <name> <mem_size> \"<instr>\"   # create a process with custom instructions\n"
+            << "  screen -f <source> <name>               # fork a process, sharing its memory copy-on-write\n"
             << "  screen -r <name>                        # re-attach to an existing process screen\n"
             << "  screen -ls                              # list processes and CPU utilization\n"
             << "  scheduler-start                         # begin generating and scheduling processes\n"
             << "  scheduler-stop                          # stop generating new processes\n"
+            << "  scheduler-turbo <count> [seed]          # run <count> processes on a virtual clock, as fast as possible\n"
             << "  process-smi                             # summary of memory use per process\n"
             << "  vmstat                                  # detailed memory, tick and paging counters\n"
+            << "  memory-stamp [<quantum>|all]            # write memory_stamp_<qq>.txt (default: latest quantum)\n"
             << "  report-util                             # write a utilization report to csopesy-log.txt\n"
             << "  clear                                   # clear the screen\n"
             << "  help                                    # show this list\n"